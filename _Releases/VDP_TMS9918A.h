@@ -36,6 +36,7 @@ VDP Registers
 #define GRAPHIC1	1	// graphics 1 mode (screen 1)
 #define GRAPHIC2	2	// graphics 2 mode (screen 2)
 #define MULTICOLOR	3	// multicolor mode (screen 3)
+#define GRAPHIC2_MASKED	4	// graphics 2 mode with one pattern and color bank for the three thirds
 
 
 
@@ -162,6 +163,68 @@ Sprite hiding coordinates
 
 
 
+/* ----------------------------------------------------------------------------
+VRAM layout: addresses of the tables of the current screen mode.
+SCREEN loads the default layout of the mode (the addresses above) and 
+SetVRAMlayout changes it. All the functions of the library use VDP_Layout.
+Without SCREEN or SetVRAMlayout (the program keeps the screen mode of BASIC 
+or MSX-DOS), or when the registers 2 to 6 are changed by other means (SetVDP, 
+BIOS), the library loads it from the VDP registers saved in the system 
+variables (RG2SAV to RG6SAV) the first time that it is needed. Use 
+GetVRAMlayout to read it from your code.
+---------------------------------------------------------------------------- */
+typedef struct {
+	unsigned int map;	//Pattern Name Table
+	unsigned int col;	//Color Table
+	unsigned int pat;	//Pattern Table
+	unsigned int oam;	//Sprite Attribute Table
+	unsigned int spr;	//Sprite Pattern Table
+} VRAM_LAYOUT;
+
+extern VRAM_LAYOUT VDP_Layout;
+
+
+
+/* ----------------------------------------------------------------------------
+Parameters of the functions with register calling (without stack)
+---------------------------------------------------------------------------- */
+// CopyToVRAMblock and CopyFromVRAMblock
+typedef struct {
+	unsigned int addr;	//Memory address
+	unsigned int vaddr;	//VRAM address
+	unsigned int size;	//block size
+} VRAM_BLOCK;
+
+// FillVRAMblock
+typedef struct {
+	unsigned int vaddr;	//VRAM address
+	unsigned int size;	//block size
+	char value;			//Value to fill
+} VRAM_FILL;
+
+// ExecVRAMlist. A list of commands ended with VCMD_END
+typedef struct {
+	char op;			//VCMD_COPY, VCMD_FILL or VCMD_END
+	unsigned int vaddr;	//VRAM address
+	unsigned int size;	//block size
+	unsigned int data;	//Memory address (VCMD_COPY) or value (VCMD_FILL)
+} VRAM_CMD;
+
+#define VCMD_END	0
+#define VCMD_COPY	1
+#define VCMD_FILL	2
+
+// PutSpriteAttr. Same order as the Sprite Attribute Table
+typedef struct {
+	char y;
+	char x;
+	char pattern;
+	char color;
+} SPRITE_ATTR;
+
+
+
+
 /* =============================================================================
 SCREEN
 Description:
@@ -177,12 +240,74 @@ Input:	[char] number of screen mode
 			1 = Graphic1
 			2 = Graphic2
 			3 = MultiColor
+			4 = Graphic2 with one bank (GRAPHIC2_MASKED). The three thirds 
+			    of the screen use the patterns of G2_PAT_A and the colors of 
+			    G2_COL_A (R#3 = 0x9F; R#4 = 0x00).
 Output:	-
 ============================================================================= */
 void SCREEN(char mode);
 
 
 
+/* =============================================================================
+SetVRAMlayout
+Description:
+		Moves the VRAM tables of the current screen mode. 
+		Writes the VDP registers 2 to 6 and copies the layout to VDP_Layout, 
+		which is used by all the functions of the library.
+		Call it after SCREEN. The tables are not initialized.
+		In Graphic2 mode, the color table and the pattern table can only be 
+		at 0x0000 or 0x2000.
+Input:	[const VRAM_LAYOUT*] pointer to the layout
+Output:	- 
+============================================================================= */
+void SetVRAMlayout(const VRAM_LAYOUT* layout);
+
+
+
+/* =============================================================================
+GetVRAMlayout
+Description:
+		Provides the addresses of the VRAM tables used by the library. 
+		If SCREEN or SetVRAMlayout has not been called (the program keeps the 
+		screen mode of BASIC or MSX-DOS), it loads VDP_Layout from the VDP 
+		registers saved in the system variables (RG2SAV to RG6SAV). 
+		It is also loaded again if the registers 2 to 6 have been changed 
+		by other means (SetVDP, BIOS).
+Input:	-
+Output:	[const VRAM_LAYOUT*] pointer to VDP_Layout
+============================================================================= */
+const VRAM_LAYOUT* GetVRAMlayout(void);
+
+
+
+/* =============================================================================
+SetBackMap
+Description:
+		Sets the address of the name table where the library writes 
+		(VDP_Layout.map), while the VDP keeps showing the current one (R#2).
+		Used for double buffering with FlipMap. 
+		The address must be a multiple of 0x400 and not overlap other tables.
+Input:	[unsigned int] VRAM address of the back name table
+Output:	- 
+============================================================================= */
+void SetBackMap(unsigned int vaddr);
+
+
+
+/* =============================================================================
+FlipMap
+Description:
+		Waits for the vertical retrace (HALT) and shows the back name table 
+		(R#2). The name table shown until now becomes the back table.
+		Requires the interrupts enabled.
+Input:	-
+Output:	- 
+============================================================================= */
+void FlipMap(void);
+
+
+
 /* =============================================================================
 SortG2map 
 Description: 
@@ -295,8 +420,9 @@ extern char FastVPEEK(void);
 FillVRAM                               
 Description:
 		Fills an area of ​​VRAM with the same value.
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
 Input:	[unsigned int] VRAM address
-		[unsigned int] block size
+		[unsigned int] block size (0 = no transfer)
 		[char] Value to fill
 Output:	- 
 ============================================================================= */
@@ -308,28 +434,108 @@ void FillVRAM(unsigned int vaddr, unsigned int size, char value);
 CopyToVRAM
 Description:
 		Block transfer from memory to VRAM 
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
 Input:	[unsigned int] Memory address
 		[unsigned int] VRAM address
-		[unsigned int] block size
+		[unsigned int] block size (0 = no transfer)
 Output:	- 
 ============================================================================= */
 void CopyToVRAM(unsigned int addr, unsigned int vaddr, unsigned int size);
 
 
 
+/* =============================================================================
+CopyToVRAM_G2x3
+Description:
+		Copies a tileset to the three banks of the Graphic2 Pattern Table 
+		(G2_PAT_A/B/C) and its colors to the three banks of the Color Table 
+		(G2_COL_A/B/C), in a single call.
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
+Input:	[unsigned int] patterns Memory address
+		[unsigned int] colors Memory address
+		[unsigned int] block size (up to 2048)
+Output:	- 
+============================================================================= */
+void CopyToVRAM_G2x3(unsigned int pat, unsigned int col, unsigned int size);
+
+
+
 /* =============================================================================
 CopyFromVRAM
 Description:
 		Block transfer from VRAM to memory
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
 Input:	[unsigned int] VRAM address                     
 		[unsigned int] RAM address
-		[unsigned int] block size
+		[unsigned int] block size (0 = no transfer)
 Output:	-
 ============================================================================= */
 void CopyFromVRAM(unsigned int vaddr, unsigned int addr, unsigned int size);
 
 
 
+/* =============================================================================
+WriteVRAMbyte
+Description:
+		Writes a value to the video RAM. Same as VPOKE, with the parameters 
+		in registers (without stack).
+Input:	[char] value
+		[unsigned int] VRAM address
+Output:	- 
+============================================================================= */
+void WriteVRAMbyte(char value, unsigned int vaddr);
+
+
+
+/* =============================================================================
+FillVRAMblock                               
+Description:
+		Fills an area of ​​VRAM with the same value. Same as FillVRAM, with the 
+		parameters in a structure (without stack).
+Input:	[VRAM_FILL*] pointer to the parameters (vaddr, size, value)
+Output:	- 
+============================================================================= */
+void FillVRAMblock(VRAM_FILL* fill);
+
+
+
+/* =============================================================================
+CopyToVRAMblock
+Description:
+		Block transfer from memory to VRAM. Same as CopyToVRAM, with the 
+		parameters in a structure (without stack).
+Input:	[VRAM_BLOCK*] pointer to the parameters (addr, vaddr, size)
+Output:	- 
+============================================================================= */
+void CopyToVRAMblock(VRAM_BLOCK* block);
+
+
+
+/* =============================================================================
+CopyFromVRAMblock
+Description:
+		Block transfer from VRAM to memory. Same as CopyFromVRAM, with the 
+		parameters in a structure (without stack).
+Input:	[VRAM_BLOCK*] pointer to the parameters (addr, vaddr, size)
+Output:	- 
+============================================================================= */
+void CopyFromVRAMblock(VRAM_BLOCK* block);
+
+
+
+/* =============================================================================
+ExecVRAMlist
+Description:
+		Executes a list of copy and fill commands in a single call.
+		The list can be in ROM and ends with a VCMD_END command.
+		Each command uses the fast loop when the display is disabled (BLK=0).
+Input:	[const VRAM_CMD*] pointer to the list of commands
+Output:	- 
+============================================================================= */
+void ExecVRAMlist(const VRAM_CMD* list);
+
+
+
 /* =============================================================================
 GetVDP
 Description:
@@ -435,6 +641,19 @@ void PUTSPRITE(char plane, char x, char y, char color, char pattern);
 
 
 
+/* =============================================================================
+PutSpriteAttr
+Description: 
+		Displays a Sprite on the screen. Same as PUTSPRITE, with the 
+		attributes in a structure (without stack).
+Input:	[char] sprite plane (0-31) 
+		[SPRITE_ATTR*] pointer to the attributes (y, x, pattern, color)
+Output:	-
+============================================================================= */
+void PutSpriteAttr(char plane, SPRITE_ATTR* attr);
+
+
+
 /* =============================================================================
 GetSPRattrVRAM
 Description: 
@@ -446,6 +665,156 @@ unsigned int GetSPRattrVRAM(char plane);
 
 
 
+/* #############################################################################
+##                                                          FRAME functions   ##
+################################################################################ */
+
+
+
+/* =============================================================================
+InitFrameSync
+Description: 
+		Starts the count of frames of WaitVBlank and GetDroppedFrames.
+		Call it before the first WaitVBlank: the count is not initialized 
+		at startup (the RAM of the program is not cleared).
+Input:	-
+Output:	-
+============================================================================= */
+void InitFrameSync(void);
+
+
+
+/* =============================================================================
+WaitVBlank
+Description: 
+		Waits for the start of the vertical retrace.
+		- With the interrupts enabled, waits (HALT) until the BIOS interrupt 
+		  routine increments JIFFY.
+		- With the interrupts disabled, reads the F flag of the status 
+		  register S#0, saves it in STATFL (with the 5S and C flags of all 
+		  the reads) and increments JIFFY. If F is already set, the retrace 
+		  started before the call and it returns at once.
+		Counts the frames lost since the previous call.
+Input:	-
+Output:	-
+============================================================================= */
+void WaitVBlank(void);
+
+
+
+/* =============================================================================
+GetFrameCount
+Description: 
+		Returns the frame counter (JIFFY).
+Input:	-
+Output:	[unsigned int] frames
+============================================================================= */
+unsigned int GetFrameCount(void);
+
+
+
+/* =============================================================================
+GetDroppedFrames
+Description: 
+		Returns the frames lost in WaitVBlank since the previous call 
+		(frames where the program did not finish in time) and resets 
+		the count.
+Input:	-
+Output:	[unsigned int] lost frames
+============================================================================= */
+unsigned int GetDroppedFrames(void);
+
+
+
+/* #############################################################################
+##                                                          STATS functions   ##
+################################################################################
+Only in the instrumented build of the library (compiled with -DVDP_STATS_BUILD). 
+Compile the program with -DVDP_STATS_BUILD too, to use these definitions.
+---------------------------------------------------------------------------- */
+#ifdef VDP_STATS_BUILD
+
+// Index of each function in VDP_STATS.calls
+#define VDPSTAT_SCREEN				0
+#define VDPSTAT_SetVRAMlayout		1
+#define VDPSTAT_SetBackMap			2
+#define VDPSTAT_FlipMap				3
+#define VDPSTAT_SortG2map			4
+#define VDPSTAT_SortMCmap			5
+#define VDPSTAT_CLS					6
+#define VDPSTAT_COLOR				7
+#define VDPSTAT_VPOKE				8
+#define VDPSTAT_VPEEK				9
+#define VDPSTAT_FillVRAM			10
+#define VDPSTAT_CopyToVRAM			11
+#define VDPSTAT_CopyToVRAM_G2x3		12
+#define VDPSTAT_CopyFromVRAM		13
+#define VDPSTAT_WriteVRAMbyte		14
+#define VDPSTAT_FillVRAMblock		15
+#define VDPSTAT_CopyToVRAMblock		16
+#define VDPSTAT_CopyFromVRAMblock	17
+#define VDPSTAT_ExecVRAMlist		18
+#define VDPSTAT_GetVDP				19
+#define VDPSTAT_SetVDP				20
+#define VDPSTAT_ClearSprites		21
+#define VDPSTAT_SetSpritesSize		22
+#define VDPSTAT_SetSpritesZoom		23
+#define VDPSTAT_PUTSPRITE			24
+#define VDPSTAT_PutSpriteAttr		25
+#define VDPSTAT_GetSPRattrVRAM		26
+#define VDPSTAT_InitFrameSync		27
+#define VDPSTAT_WaitVBlank			28
+#define VDPSTAT_GetFrameCount		29
+#define VDPSTAT_GetDroppedFrames	30
+#define VDPSTAT_GetVRAMlayout		31
+
+#define VDPSTAT_FUNCTIONS			32
+
+
+
+/* ----------------------------------------------------------------------------
+Statistics of the instrumented build
+SetVDPtoWRITE, SetVDPtoREAD, FastVPOKE and FastVPEEK are not in calls: they 
+are counted in setups and in the bytes transferred.
+---------------------------------------------------------------------------- */
+typedef struct {
+	unsigned int  setups;		// VRAM address setups (SetVDPtoWRITE/SetVDPtoREAD)
+	unsigned int  registers;	// VDP register writes
+	unsigned long written;		// bytes written to VRAM
+	unsigned long read;			// bytes read from VRAM
+	unsigned int  calls[VDPSTAT_FUNCTIONS];	// calls to each function (VDPSTAT_xxx)
+} VDP_STATS;
+
+
+
+/* =============================================================================
+GetVDPstats
+Description: 
+		Returns the statistics of the instrumented build, accumulated since 
+		the last ResetVDPstats. 
+		The calls made by other functions of the library are also counted.
+Input:	-
+Output:	[const VDP_STATS*] pointer to the statistics
+============================================================================= */
+const VDP_STATS* GetVDPstats(void);
+
+
+
+/* =============================================================================
+ResetVDPstats
+Description: 
+		Clears the statistics. 
+		Call it at the start of the program and at the start of each 
+		interval to be measured (e.g. after WaitVBlank).
+Input:	-
+Output:	-
+============================================================================= */
+void ResetVDPstats(void);
+
+#endif
+
+
+
 
 
 
@@ -495,7 +864,7 @@ Label: fillVR
 Description:
 		Fill a large area of the VRAM of the same value.
 Input:	HL - VRAM address
-		DE - Size
+		DE - Size (0 = no transfer)
 		A  - value
 Output:	-
 Regs:	BC
@@ -506,7 +875,7 @@ Description:
 		Block transfer from memory to VRAM 
 Input:	DE - source Memory address
 		HL - target VRAM address
-		BC - block size
+		BC - block size (0 = no transfer)
 Output:	-
 Regs:	A
 
@@ -517,7 +886,41 @@ Description:
 		Block transfer from VRAM to memory.  
 Input:	HL - source VRAM address                     
 		DE - target RAM address
-		BC - block size
+		BC - block size (0 = no transfer)
+Output:	-
+Regs:	A
+
+--------------------------------------------------------------------------------
+Label: fastFillVR                                
+Description:
+		Fill a large area of the VRAM of the same value, without the 
+		29 T-states pacing.
+		Only when the display is disabled (BLK=0) or during vertical retrace.
+Input:	HL - VRAM address
+		DE - Size (0 = no transfer)
+		A  - value
+Output:	-
+Regs:	BC
+
+--------------------------------------------------------------------------------
+Label: fastLDIR2VRAM
+Description:
+		Block transfer from memory to VRAM, without the 29 T-states pacing.
+		Only when the display is disabled (BLK=0) or during vertical retrace.
+Input:	DE - source Memory address
+		HL - target VRAM address
+		BC - block size (0 = no transfer)
+Output:	-
+Regs:	A
+
+--------------------------------------------------------------------------------
+Label: fastGetBLOCKfromVRAM
+Description: 
+		Block transfer from VRAM to memory, without the 29 T-states pacing.
+		Only when the display is disabled (BLK=0) or during vertical retrace.
+Input:	HL - source VRAM address                     
+		DE - target RAM address
+		BC - block size (0 = no transfer)
 Output:	-
 Regs:	A
 
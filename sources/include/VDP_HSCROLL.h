@@ -0,0 +1,58 @@
+/* =============================================================================
+VDP_HSCROLL MSX SDCC Library (fR3eL Project)
+Smooth horizontal scroll (1 pixel) with pre-shifted tiles in Graphic2 mode
+============================================================================= */
+#ifndef  __VDP_HSCROLL_H__
+#define  __VDP_HSCROLL_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Pair of tiles (left and right) that generates 8 shifted tiles, from the 
+pattern "tile" (multiple of 8) to "tile"+7. The tile "tile"+s shows the 
+pair moved s pixels to the left. 
+All the rows of the 8 tiles use the colors of "color".
+---------------------------------------------------------------------------- */
+typedef struct {
+	const char* left;	//8 bytes of pattern
+	const char* right;	//8 bytes of pattern
+	const char* color;	//8 bytes of color
+	char tile;			//first pattern number
+} SHIFT_PAIR;
+
+
+
+/* =============================================================================
+BuildShiftedPair
+Description: 
+		Generates the 8 shifted tiles of a pair and writes them (patterns 
+		and colors) to the banks of the Graphic2 mode (one bank in 
+		GRAPHIC2_MASKED mode). 
+		In Graphic1 mode it only writes the patterns: the color table has 
+		one byte for each group of 8 patterns.
+		Writes 128 bytes per bank: build one pair per frame if the display 
+		is enabled.
+Input:	[const SHIFT_PAIR*] pair
+Output:	-
+============================================================================= */
+void BuildShiftedPair(const SHIFT_PAIR* pair);
+
+
+
+/* =============================================================================
+HScrollBand
+Description: 
+		Writes a band of rows of the name table, adding the shift (0-7) to 
+		each tile. The band contains the first tile of the pairs.
+		Cost: 46 T-states per byte (32 per row) plus about 150.
+Input:	[const char*] band (rows x 32 tiles)
+		[char] first row of the screen
+		[char] number of rows
+		[char] shift (0-7)
+Output:	-
+============================================================================= */
+void HScrollBand(const char* band, char row, char rows, char shift);
+
+
+
+#endif
@@ -0,0 +1,89 @@
+/* =============================================================================
+VDP_ISR MSX SDCC Library (fR3eL Project)
+Interrupt routine (IM1) of the VDP for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_ISR_H__
+#define  __VDP_ISR_H__
+
+
+
+#define ISR_CALLBACKS	4	//maximum number of functions
+
+
+
+/* =============================================================================
+InstallISR
+Description: 
+		Replaces the interrupt routine at 0x0038 with VDP_ISR.
+		Requires RAM in page 0 (MSX-DOS or 64K RAM configurations).
+		In a ROM with its own page 0, put a JP VDP_ISR at 0x0038 instead.
+		VDP_ISR reads S#0, saves it in STATFL, increments JIFFY and calls 
+		the functions added with AddISRcallback. 
+		The BIOS routine (keyboard, H.TIMI hook...) is not executed unless 
+		it is enabled with SetISRchain (see SetISRchain).
+		Empties the list of functions: add them after InstallISR.
+Input:	-
+Output:	-
+============================================================================= */
+void InstallISR(void);
+
+
+
+/* =============================================================================
+RemoveISR
+Description: 
+		Restores the previous interrupt routine at 0x0038 and, if 
+		SetISRchain is enabled, the previous H.TIMI hook.
+Input:	-
+Output:	-
+============================================================================= */
+void RemoveISR(void);
+
+
+
+/* =============================================================================
+AddISRcallback
+Description: 
+		Adds a function to the list that VDP_ISR calls at the start of the 
+		vertical retrace, in the order they were added (up to ISR_CALLBACKS).
+		They are called with the interrupts disabled and S#0 already read, 
+		but the VRAM functions of the library enable them (EI) when they 
+		end: the functions of the list must end before the next interrupt.
+Input:	[void (*)(void)] function
+Output:	[char] 1 = added; 0 = the list is full
+============================================================================= */
+char AddISRcallback(void (*callback)(void));
+
+
+
+/* =============================================================================
+ClearISRcallbacks
+Description: 
+		Empties the list of functions.
+Input:	-
+Output:	-
+============================================================================= */
+void ClearISRcallbacks(void);
+
+
+
+/* =============================================================================
+SetISRchain
+Description: 
+		Enables or disables the jump to the previous interrupt routine. 
+		With the jump enabled, VDP_ISR does not read S#0: the BIOS routine 
+		reads it, saves it in STATFL and executes H.TIMI, the keyboard scan 
+		and the JIFFY increment as usual. The functions of the list are 
+		called from the H.TIMI hook, before the keyboard scan.
+		The previous hook is called after them. If other hooks are 
+		installed in H.TIMI (EnableVQueueHook...), remove them in the 
+		reverse order.
+		Keeps the interrupt state of the caller.
+Input:	[char] 0 = no; 1 = jump to the previous routine
+Output:	-
+============================================================================= */
+void SetISRchain(char chain);
+
+
+
+#endif
@@ -0,0 +1,91 @@
+/* =============================================================================
+VDP_MAPBUFFER MSX SDCC Library (fR3eL Project)
+Pattern Name Table buffer in RAM for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_MAPBUFFER_H__
+#define  __VDP_MAPBUFFER_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Size of the buffer: the biggest name table (Text1 40x24)
+---------------------------------------------------------------------------- */
+#define MAPBUFFER_ROWS	24
+#define MAPBUFFER_SIZE	(40*24)
+
+
+
+/* ----------------------------------------------------------------------------
+RAM mirror of the Pattern Name Table. 
+Rows of 40 bytes in Text1 mode and 32 bytes in the other modes.
+If you write in it directly, mark the rows with SetMapRowDirty.
+---------------------------------------------------------------------------- */
+extern char MapBuffer[MAPBUFFER_SIZE];
+
+
+
+/* =============================================================================
+InitMapBuffer
+Description: 
+		Initializes the buffer for the current screen mode (name table 
+		address and row width) and fills it with 0, like SCREEN and CLS.
+		Call it after SCREEN.
+Input:	-
+Output:	-
+============================================================================= */
+void InitMapBuffer(void);
+
+
+
+/* =============================================================================
+SetMapTile
+Description: 
+		Writes a tile in the buffer and marks its row as modified.
+Input:	[char] column
+		[char] row (0-23)
+		[char] tile number
+Output:	-
+============================================================================= */
+void SetMapTile(char column, char row, char tile);
+
+
+
+/* =============================================================================
+GetMapTile
+Description: 
+		Reads a tile from the buffer.
+Input:	[char] column
+		[char] row (0-23)
+Output:	[char] tile number
+============================================================================= */
+char GetMapTile(char column, char row);
+
+
+
+/* =============================================================================
+SetMapRowDirty
+Description: 
+		Marks a row of the buffer as modified, to be sent by FlushMapBuffer.
+Input:	[char] row (0-23)
+Output:	-
+============================================================================= */
+void SetMapRowDirty(char row);
+
+
+
+/* =============================================================================
+FlushMapBuffer
+Description: 
+		Sends the modified rows to the Pattern Name Table. 
+		Consecutive rows are sent in a single block.
+		If the name table has changed since the last call (FlipMap), it also 
+		sends the rows that were sent to the other table since this one was 
+		last written.
+Input:	-
+Output:	-
+============================================================================= */
+void FlushMapBuffer(void);
+
+
+
+#endif
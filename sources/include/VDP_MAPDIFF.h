@@ -0,0 +1,49 @@
+/* =============================================================================
+VDP_MAPDIFF MSX SDCC Library (fR3eL Project)
+Differential dump of the Pattern Name Table buffer (VDP_MAPBUFFER)
+============================================================================= */
+#ifndef  __VDP_MAPDIFF_H__
+#define  __VDP_MAPDIFF_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Maximum number of unchanged bytes that are written between two modified 
+runs instead of setting a new VRAM address (29 T-states per byte against 
+about 130 T-states of a new address).
+---------------------------------------------------------------------------- */
+#define MAPDIFF_GAP	4
+
+
+
+/* =============================================================================
+InitMapDiff
+Description: 
+		Copies the buffer (MapBuffer) to the copy of the last values sent 
+		to VRAM. Call it after InitMapBuffer or when the buffer and the VRAM 
+		have the same content.
+Input:	-
+Output:	-
+============================================================================= */
+void InitMapDiff(void);
+
+
+
+/* =============================================================================
+FlushMapDiff
+Description: 
+		Compares the modified rows of the buffer with the last values sent 
+		to VRAM and only writes the bytes that have changed.
+		Runs of changed bytes separated by up to MAPDIFF_GAP unchanged bytes 
+		are written as a single block.
+		Do not mix it with FlushMapBuffer.
+		Only for a single name table: it does not follow the FlipMap swaps 
+		(SetBackMap/FlipMap).
+Input:	-
+Output:	-
+============================================================================= */
+void FlushMapDiff(void);
+
+
+
+#endif
@@ -0,0 +1,130 @@
+/* =============================================================================
+VDP_OAM MSX SDCC Library (fR3eL Project)
+Sprite Attribute Table (OAM) buffer in RAM for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_OAM_H__
+#define  __VDP_OAM_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Size of the Sprite Attribute Table: 32 planes x 4 bytes (Y, X, pattern, color)
+---------------------------------------------------------------------------- */
+#define OAM_SIZE	128
+
+
+
+/* ----------------------------------------------------------------------------
+RAM mirror of the Sprite Attribute Table
+---------------------------------------------------------------------------- */
+extern char OAMbuffer[OAM_SIZE];
+
+
+
+/* =============================================================================
+ClearOAM
+Description: 
+		Initialises the RAM buffer of the Sprite Attribute Table.
+		The vertical location of the sprites is set to 209.
+		Does not access the VRAM. Use FlushOAM to display it.
+Input:	-
+Output:	-
+============================================================================= */
+void ClearOAM(void);
+
+
+
+/* =============================================================================
+SetOAMposition
+Description: 
+		Sets the position of a sprite in the RAM buffer.
+Input:	[char] sprite plane (0-31) 
+		[char] X coordinate 
+		[char] Y coordinate
+Output:	-
+============================================================================= */
+void SetOAMposition(char plane, char x, char y);
+
+
+
+/* =============================================================================
+SetOAMpattern
+Description: 
+		Sets the pattern of a sprite in the RAM buffer.
+		In 16x16 mode the value is multiplied by 4, like PUTSPRITE.
+Input:	[char] sprite plane (0-31) 
+		[char] pattern number
+Output:	-
+============================================================================= */
+void SetOAMpattern(char plane, char pattern);
+
+
+
+/* =============================================================================
+SetOAMcolor
+Description: 
+		Sets the color of a sprite in the RAM buffer.
+Input:	[char] sprite plane (0-31) 
+		[char] color (0-15) + Early Clock bit (128)
+Output:	-
+============================================================================= */
+void SetOAMcolor(char plane, char color);
+
+
+
+/* =============================================================================
+PutSpriteOAM
+Description: 
+		Same as PUTSPRITE, but only writes to the RAM buffer.
+Input:	[char] sprite plane (0-31) 
+		[char] X coordinate 
+		[char] Y coordinate
+		[char] color (0-15)
+		[char] pattern number
+Output:	-
+============================================================================= */
+void PutSpriteOAM(char plane, char x, char y, char color, char pattern);
+
+
+
+/* =============================================================================
+FlushOAM
+Description: 
+		Dumps the RAM buffer to the Sprite Attribute Table (VDP_Layout.oam) in a 
+		single block (one VRAM address setup).
+Input:	-
+Output:	-
+============================================================================= */
+void FlushOAM(void);
+
+
+
+
+
+
+
+/* ############################################################################# 
+                                                         ASSEMBLE INLINE RUTINES
+
+--------------------------------------------------------------------------------
+Label:	GetOAMbufferADDR
+Description:
+		Gets the RAM address of the attributes of a sprite plane in the buffer.
+Input:	A  - sprite plane (0-31)
+Output:	HL - RAM address
+Regs:	DE
+
+--------------------------------------------------------------------------------
+Label:	fastFlushOAM
+Description:
+		Same as FlushOAM without the 29 T-states pacing.
+		Only when the display is disabled (BLK=0) or during vertical retrace.
+Input:	-
+Output:	-
+Regs:	A, BC, DE, HL
+
+============================================================================= */
+
+
+
+#endif
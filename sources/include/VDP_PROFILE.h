@@ -0,0 +1,52 @@
+/* =============================================================================
+VDP_PROFILE MSX SDCC Library (fR3eL Project)
+Border colour profiler for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_PROFILE_H__
+#define  __VDP_PROFILE_H__
+
+
+
+#define PROFILE_DEPTH	8	//levels of nesting
+
+
+
+/* =============================================================================
+ProfileBegin
+Description: 
+		Starts a section of code: changes the border colour.
+		Writes directly in VDP register 7 (one register write), without 
+		updating the system variables.
+		In SCREEN 0 it changes the background colour.
+Input:	[char] colour of the section (0-15)
+Output:	-
+============================================================================= */
+void ProfileBegin(char color);
+
+
+
+/* =============================================================================
+ProfileEnd
+Description: 
+		Ends the last section started: restores the colour of the section 
+		that contains it, or the colour of the COLOR function.
+Input:	-
+Output:	-
+============================================================================= */
+void ProfileEnd(void);
+
+
+
+/* =============================================================================
+ResetProfile
+Description: 
+		Closes all the sections and restores the colour of the COLOR function.
+		Call it at the start of the program, after COLOR/SCREEN.
+Input:	-
+Output:	-
+============================================================================= */
+void ResetProfile(void);
+
+
+
+#endif
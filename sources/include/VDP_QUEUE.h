@@ -0,0 +1,255 @@
+/* =============================================================================
+VDP_QUEUE MSX SDCC Library (fR3eL Project)
+Deferred VRAM command queue, executed in the vertical retrace, 
+for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_QUEUE_H__
+#define  __VDP_QUEUE_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Number of entries of the queue (power of 2). One entry is always kept free.
+---------------------------------------------------------------------------- */
+#define VQUEUE_SIZE	16
+
+
+
+/* ----------------------------------------------------------------------------
+Default number of bytes written to VRAM in each vertical retrace.
+Each command (or step of a transfer) also takes VQUEUE_CMDCOST bytes of the 
+budget: the time of reading the entry and setting the VRAM address.
+Vertical retrace: NTSC 70 lines x 228 = 15960 T-states; 
+                  PAL 121 lines x 228 = 27588 T-states.
+Budget: 19.4 T-states per byte (unpaced copy) + one command over budget 
+(about 930 T-states) + the BIOS interrupt routine until H.TIMI and 
+DrainVQueue start (about 400 T-states). 
+It leaves about 3400 (NTSC) and 3900 (PAL) T-states for the interrupt 
+latency (DI sections of the program) and the other hooks.
+---------------------------------------------------------------------------- */
+#define VQUEUE_BUDGET_NTSC	576
+#define VQUEUE_BUDGET_PAL	1152
+#define VQUEUE_CMDCOST		48
+
+
+
+/* ----------------------------------------------------------------------------
+Resumable transfer from memory to VRAM (handle).
+The fields are updated by DrainVQueue; do not modify them while the 
+transfer is running.
+---------------------------------------------------------------------------- */
+typedef struct VRAM_TRANSFER_s {
+	char op;						//reserved
+	char value;						//reserved
+	unsigned int vaddr;				//next VRAM address
+	unsigned int size;				//bytes left
+	unsigned int addr;				//next Memory address
+	struct VRAM_TRANSFER_s* next;	//reserved
+} VRAM_TRANSFER;
+
+
+
+/* =============================================================================
+InitVQueue
+Description: 
+		Initializes the queue (empty), resumes it (ResumeVQueue) and sets the 
+		byte budget per frame according to the interrupt frequency of the 
+		computer (50/60Hz).
+Input:	-
+Output:	-
+============================================================================= */
+void InitVQueue(void);
+
+
+
+/* =============================================================================
+SetVQueueBudget
+Description: 
+		Sets the maximum number of bytes written to VRAM in each call to 
+		DrainVQueue. A copy or fill bigger than the remaining budget is 
+		continued in the next frame.
+Input:	[unsigned int] bytes per frame
+Output:	-
+============================================================================= */
+void SetVQueueBudget(unsigned int size);
+
+
+
+/* =============================================================================
+SetVQueueBudgets
+Description: 
+		Sets the bytes per frame for 60Hz and 50Hz computers.
+		The value is chosen according to the interrupt frequency of the 
+		computer.
+Input:	[unsigned int] bytes per frame at 60Hz (NTSC)
+		[unsigned int] bytes per frame at 50Hz (PAL)
+Output:	-
+============================================================================= */
+void SetVQueueBudgets(unsigned int ntsc, unsigned int pal);
+
+
+
+/* =============================================================================
+QueueCopyToVRAM
+Description: 
+		Adds a block transfer from memory to VRAM to the queue.
+		The memory block must not be modified until the transfer is done.
+Input:	[unsigned int] Memory address
+		[unsigned int] VRAM address
+		[unsigned int] block size
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueCopyToVRAM(unsigned int addr, unsigned int vaddr, unsigned int size);
+
+
+
+/* =============================================================================
+QueueFillVRAM
+Description: 
+		Adds a fill of an area of VRAM to the queue.
+Input:	[unsigned int] VRAM address
+		[unsigned int] block size
+		[char] Value to fill
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueFillVRAM(unsigned int vaddr, unsigned int size, char value);
+
+
+
+/* =============================================================================
+QueueVPOKE
+Description: 
+		Adds the write of a value to VRAM to the queue.
+Input:	[unsigned int] VRAM address
+		[char] value
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueVPOKE(unsigned int vaddr, char value);
+
+
+
+/* =============================================================================
+QueueSetVDP
+Description: 
+		Adds the write of a VDP register to the queue.
+		The system variable of the register is updated when it is executed.
+Input:	[char] register number (0-7)
+		[char] value
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueSetVDP(char reg, char value);
+
+
+
+/* =============================================================================
+StartVRAMtransfer
+Description: 
+		Starts a block transfer from memory to VRAM that advances in each 
+		DrainVQueue with the budget left by the queue commands, until it is 
+		completed. Several transfers are executed in order of start.
+		Do not start again a transfer that is not done.
+Input:	[VRAM_TRANSFER*] transfer handle
+		[unsigned int] Memory address
+		[unsigned int] VRAM address
+		[unsigned int] block size
+Output:	-
+============================================================================= */
+void StartVRAMtransfer(VRAM_TRANSFER* transfer, unsigned int addr, unsigned int vaddr, unsigned int size);
+
+
+
+/* =============================================================================
+IsVRAMtransferDone
+Description: 
+		Indicates if a transfer has been completed.
+Input:	[VRAM_TRANSFER*] transfer handle
+Output:	[char] 1 = done; 0 = running
+============================================================================= */
+char IsVRAMtransferDone(VRAM_TRANSFER* transfer);
+
+
+
+/* =============================================================================
+IsVQueueEmpty
+Description: 
+		Indicates if all the commands of the queue have been executed.
+Input:	-
+Output:	[char] 1 = empty; 0 = pending commands
+============================================================================= */
+char IsVQueueEmpty(void);
+
+
+
+/* =============================================================================
+DrainVQueue
+Description: 
+		Executes the commands of the queue and then advances the running 
+		transfers, with the unpaced VRAM access, until there is nothing left 
+		to do or the byte budget is used up.
+		Only call it in the vertical retrace (or with the display disabled).
+		The VRAM functions that it uses enable the interrupts (EI). If the 
+		drain does not end before the next interrupt and this one calls 
+		DrainVQueue again (hook, VDP_ISR), the second call returns at once 
+		and the first one continues.
+Input:	-
+Output:	-
+============================================================================= */
+void DrainVQueue(void);
+
+
+
+/* =============================================================================
+EnableVQueueHook
+Description: 
+		Installs DrainVQueue in the hook of the VDP interrupt (H.TIMI).
+		The previous hook is called after draining the queue.
+		While the hook is enabled, the interrupt changes the VRAM address: 
+		the functions that access the VRAM must be called between 
+		PauseVQueue and ResumeVQueue.
+		Keeps the interrupt state of the caller.
+Input:	-
+Output:	-
+============================================================================= */
+void EnableVQueueHook(void);
+
+
+
+/* =============================================================================
+DisableVQueueHook
+Description: 
+		Restores the previous H.TIMI hook.
+		Keeps the interrupt state of the caller.
+Input:	-
+Output:	-
+============================================================================= */
+void DisableVQueueHook(void);
+
+
+
+/* =============================================================================
+PauseVQueue
+Description: 
+		The hook stops executing the queue (the commands are kept), so the 
+		program can use the functions that access the VRAM (CopyToVRAM, 
+		VPOKE, PUTSPRITE, FlushOAM...).
+		The functions that only write registers (SetVDP, COLOR...) or RAM 
+		buffers can be used without pausing it.
+Input:	-
+Output:	-
+============================================================================= */
+void PauseVQueue(void);
+
+
+
+/* =============================================================================
+ResumeVQueue
+Description: 
+		The hook executes the queue again from the next interrupt.
+Input:	-
+Output:	-
+============================================================================= */
+void ResumeVQueue(void);
+
+
+
+#endif
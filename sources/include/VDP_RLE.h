@@ -0,0 +1,35 @@
+/* =============================================================================
+VDP_RLE MSX SDCC Library (fR3eL Project)
+RLE decompression to VRAM for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_RLE_H__
+#define  __VDP_RLE_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Format of the compressed data (sequence of blocks):
+	0x00			end of data
+	0x01-0x7F		n literal bytes follow (1-127)
+	0x80-0xFF v		run of (n AND 0x7F)+1 times the value v (1-128)
+---------------------------------------------------------------------------- */
+#define RLE_END		0x00
+#define RLE_RUN		0x80
+
+
+
+/* =============================================================================
+RLEtoVRAM
+Description: 
+		Decompresses RLE data directly to VRAM.
+		The runs are written with the fillVR loop and the literals with 
+		the LDIR2VRAM loop (unpaced when the display is disabled).
+Input:	[unsigned int] compressed data Memory address
+		[unsigned int] VRAM address
+Output:	[unsigned int] next VRAM address after the decompressed data
+============================================================================= */
+unsigned int RLEtoVRAM(unsigned int addr, unsigned int vaddr);
+
+
+
+#endif
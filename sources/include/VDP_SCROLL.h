@@ -0,0 +1,111 @@
+/* =============================================================================
+VDP_SCROLL MSX SDCC Library (fR3eL Project)
+Tile scroll (8 pixels) of a map for Graphic1 and Graphic2 modes
+============================================================================= */
+#ifndef  __VDP_SCROLL_H__
+#define  __VDP_SCROLL_H__
+
+
+
+#define SCROLL_COLUMNS	32
+#define SCROLL_ROWS		24
+
+
+
+/* ----------------------------------------------------------------------------
+World map: tiles stored row by row (can be in ROM)
+---------------------------------------------------------------------------- */
+typedef struct {
+	const char* map;		//tiles
+	unsigned int width;		//columns (32 or more)
+	unsigned int height;	//rows (24 or more)
+} SCROLL_MAP;
+
+
+
+/* ----------------------------------------------------------------------------
+Position of the window in the map (upper left tile)
+---------------------------------------------------------------------------- */
+extern unsigned int SCROLL_x;
+extern unsigned int SCROLL_y;
+
+
+
+/* =============================================================================
+InitScroll
+Description: 
+		Initializes the scroll with a map and the position of the window, 
+		and loads the visible window in the RAM buffer.
+		Call FlushScroll to show it.
+Input:	[const SCROLL_MAP*] map
+		[unsigned int] column of the window
+		[unsigned int] row of the window
+Output:	-
+============================================================================= */
+void InitScroll(const SCROLL_MAP* world, unsigned int x, unsigned int y);
+
+
+
+/* =============================================================================
+ScrollRight
+Description: 
+		Moves the window one tile to the right (the map scrolls to the left).
+		Only the new column is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollRight(void);
+
+
+
+/* =============================================================================
+ScrollLeft
+Description: 
+		Moves the window one tile to the left.
+		Only the new column is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollLeft(void);
+
+
+
+/* =============================================================================
+ScrollDown
+Description: 
+		Moves the window one tile down.
+		Only the new row is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollDown(void);
+
+
+
+/* =============================================================================
+ScrollUp
+Description: 
+		Moves the window one tile up.
+		Only the new row is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollUp(void);
+
+
+
+/* =============================================================================
+FlushScroll
+Description: 
+		Sends the window to the name table (VDP_Layout.map) with a single 
+		VRAM address setup. 
+		Takes about 26400 T-states: use it with SetBackMap/FlipMap to avoid 
+		tearing.
+Input:	-
+Output:	-
+============================================================================= */
+void FlushScroll(void);
+
+
+
+#endif
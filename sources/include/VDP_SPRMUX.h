@@ -0,0 +1,78 @@
+/* =============================================================================
+VDP_SPRMUX MSX SDCC Library (fR3eL Project)
+Sprite multiplexer for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_SPRMUX_H__
+#define  __VDP_SPRMUX_H__
+
+
+
+/* ----------------------------------------------------------------------------
+Maximum number of logical sprites (the VDP only has 32 planes)
+---------------------------------------------------------------------------- */
+#define SPRMUX_MAX	64
+
+
+
+/* ----------------------------------------------------------------------------
+Value returned by AddSpriteMUX when the logical list is full
+---------------------------------------------------------------------------- */
+#define SPRMUX_FULL	0xFF
+
+
+
+/* =============================================================================
+InitSpriteMUX
+Description: 
+		Initializes the sprite multiplexer.
+		Empties the logical list and resets the priority rotation.
+Input:	-
+Output:	-
+============================================================================= */
+void InitSpriteMUX(void);
+
+
+
+/* =============================================================================
+ClearSpriteMUX
+Description: 
+		Empties the logical sprite list. 
+		Call it at the beginning of each frame, before adding the sprites.
+Input:	-
+Output:	-
+============================================================================= */
+void ClearSpriteMUX(void);
+
+
+
+/* =============================================================================
+AddSpriteMUX
+Description: 
+		Adds a sprite to the logical list.
+		Y=208 is the end of table mark of the VDP, do not use it.
+Input:	[char] X coordinate 
+		[char] Y coordinate
+		[char] color (0-15)
+		[char] pattern number
+Output:	[char] index in the logical list or SPRMUX_FULL
+============================================================================= */
+char AddSpriteMUX(char x, char y, char color, char pattern);
+
+
+
+/* =============================================================================
+UpdateSpriteMUX
+Description: 
+		Sorts the logical list by Y, rotates the priorities and writes the 
+		result to the Sprite Attribute Table (VDP_Layout.oam) in one pass.
+		The rotation uses the 5th sprite flag and number of the status 
+		register S#0 stored in STATFL by the interrupt routine. If there are 
+		no more than four sprites per line, the order is kept (no flicker).
+Input:	-
+Output:	-
+============================================================================= */
+void UpdateSpriteMUX(void);
+
+
+
+#endif
@@ -0,0 +1,117 @@
+/* =============================================================================
+VDP_TMS9918A MSX SDCC Library (fR3eL Project)
+Inline access to the VDP ports (optional header)
+
+Declares the VDP ports with __sfr so that the compiler generates the IN/OUT 
+instructions directly in your code, without calling a function.
+It does not need the library (.rel), but can be used with it.
+
+Keep in mind that, unlike the functions of the library, VDP_FastVPOKE and 
+VDP_FastVPEEK do not add any delay. With the display enabled, leave at least 
+29 T-states between two accesses to the VRAM.
+============================================================================= */
+#ifndef  __VDP_TMS9918A_INLINE_H__
+#define  __VDP_TMS9918A_INLINE_H__
+
+
+
+
+/* ----------------------------------------------------------------------------
+VDP Ports
+---------------------------------------------------------------------------- */
+__sfr __at 0x98 VDPVRAMport;	//VRAM Data (Read/Write)
+__sfr __at 0x99 VDPSTATUSport;	//VDP Status Registers / address and register setup
+
+
+
+/* ----------------------------------------------------------------------------
+Mirror of the VDP registers in the MSX system variables (RG0SAV)
+---------------------------------------------------------------------------- */
+#define VDP_REGSAV	((volatile char*) 0xF3DF)
+
+
+
+
+/* =============================================================================
+VDP_FastVPOKE
+Description:
+		Writes a value to the next position in video RAM.
+		Requires the VDP to be in write mode (VDP_SetWRITE, SetVDPtoWRITE or 
+		VPOKE).
+Input:	[char] value
+Output:	-
+============================================================================= */
+#define VDP_FastVPOKE(value)	(VDPVRAMport = (value))
+
+
+
+/* =============================================================================
+VDP_FastVPEEK
+Description:
+		Reads the value of the next position in video RAM.
+		Requires the VDP to be in read mode (VDP_SetREAD, SetVDPtoREAD or 
+		VPEEK).
+Input:	-
+Output:	[char] value
+============================================================================= */
+#define VDP_FastVPEEK()		(VDPVRAMport)
+
+
+
+/* =============================================================================
+VDP_SetWRITE
+Description:
+		Sets the VDP to write VRAM mode and indicates the start address.
+		Same as SetVDPtoWRITE.
+Input:	[unsigned int] VRAM address
+Output:	-
+============================================================================= */
+static inline void VDP_SetWRITE(unsigned int vaddr)
+{
+	__asm__("di");
+	VDPSTATUSport = vaddr & 0xFF;
+	VDPSTATUSport = ((vaddr >> 8) & 0x3F) | 0x40;	//bit6 = 1 --> write access
+	__asm__("ei");
+}
+
+
+
+/* =============================================================================
+VDP_SetREAD
+Description:
+		Sets the VDP to read VRAM mode and indicates the start address.
+		Same as SetVDPtoREAD.
+Input:	[unsigned int] VRAM address
+Output:	-
+============================================================================= */
+static inline void VDP_SetREAD(unsigned int vaddr)
+{
+	__asm__("di");
+	VDPSTATUSport = vaddr & 0xFF;
+	VDPSTATUSport = (vaddr >> 8) & 0x3F;				//bit6 = 0 --> read access
+	__asm__("ei");
+}
+
+
+
+/* =============================================================================
+VDP_SetRegister
+Description:
+		Writes a value to a VDP register and saves it in the system variables.
+		Same as SetVDP.
+Input:	[char] register number (0-7)
+		[char] value
+Output:	-
+============================================================================= */
+static inline void VDP_SetRegister(char reg, char value)
+{
+	VDP_REGSAV[reg] = value;
+	__asm__("di");
+	VDPSTATUSport = value;
+	VDPSTATUSport = reg | 0x80;
+	__asm__("ei");
+}
+
+
+
+#endif
@@ -0,0 +1,60 @@
+/* =============================================================================
+VDP_VSCROLL MSX SDCC Library (fR3eL Project)
+Smooth vertical scroll (1 pixel) by rolling the patterns of the background
+============================================================================= */
+#ifndef  __VDP_VSCROLL_H__
+#define  __VDP_VSCROLL_H__
+
+
+
+/* =============================================================================
+BuildVScrollSet
+Description: 
+		Generates the 8 rolled copies (offset 0 to 7) of a set of tiles. 
+		In the copy of offset p, each tile shows the last p lines of the 
+		tile above it followed by its first 8-p lines.
+		Use it for the patterns and, in Graphic2, for the colors.
+Input:	[char*] target buffer (count x 64 bytes)
+		[const char*] tiles (count x 8 bytes)
+		[const char*] index of the tile above each tile (count bytes)
+		[char] number of tiles
+Output:	-
+============================================================================= */
+void BuildVScrollSet(char* rolled, const char* tiles, const char* above, char count);
+
+
+
+/* =============================================================================
+InitVScroll
+Description: 
+		Sets the rolled copies of the background tiles (8 sets of count x 8 
+		bytes, in RAM or ROM) and the first pattern number they use.
+Input:	[const char*] rolled patterns
+		[const char*] rolled colors (0 = the colors do not roll; Graphic2 only)
+		[char] first pattern number
+		[char] number of tiles
+Output:	-
+============================================================================= */
+void InitVScroll(const char* patterns, const char* colors, char first, char count);
+
+
+
+/* =============================================================================
+SetVScroll
+Description: 
+		Writes the rolled copy of an offset (0-7) to the pattern table (and 
+		to the color table in Graphic2) of the current mode. In Graphic2 it 
+		writes the three banks, except in GRAPHIC2_MASKED mode.
+		In Graphic1 the colors are not written, even if InitVScroll has 
+		them: the color table has one byte for each group of 8 patterns.
+		Call it in the vertical retrace. Every 8 pixels the name table 
+		must move one row in the same frame.
+		Cost: count x 8 bytes per table and bank, 29 T-states per byte.
+Input:	[char] offset (0-7)
+Output:	-
+============================================================================= */
+void SetVScroll(char offset);
+
+
+
+#endif
@@ -0,0 +1,24 @@
+/* =============================================================================
+VDP_ZX0 MSX SDCC Library (fR3eL Project)
+ZX0 decompression to VRAM for the VDP_TMS9918A Library
+============================================================================= */
+#ifndef  __VDP_ZX0_H__
+#define  __VDP_ZX0_H__
+
+
+
+/* =============================================================================
+ZX0toVRAM
+Description: 
+		Decompresses data in ZX0 format (v2, by Einar Saukas) directly to 
+		VRAM. The back-references are read from the data already written 
+		to VRAM, so it does not need a window buffer in RAM.
+Input:	[unsigned int] compressed data Memory address
+		[unsigned int] VRAM address
+Output:	[unsigned int] next VRAM address after the decompressed data
+============================================================================= */
+unsigned int ZX0toVRAM(unsigned int addr, unsigned int vaddr);
+
+
+
+#endif
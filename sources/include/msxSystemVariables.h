@@ -251,6 +251,9 @@
 
 #define HIMEM	0xFC4A		//Stack at the top of memory
 
+#define JIFFY	0xFC9E		//(2B)	Counter incremented on each VDP interrupt (frame counter)
+#define INTCNT	0xFCA2		//(2B)	Counter used by ON INTERVAL GOSUB
+
 #define EXPTBL	0xFCC1		//(1B)	Slot 0: #80 = expanded, 0 = not expanded. Also slot address of the main BIOS-ROM.
 			//  0xFCC2        (1B)	Slot 1: #80 = expanded, 0 = not expanded.
 			//  0xFCC3        (1B)	Slot 2: #80 = expanded, 0 = not expanded.
@@ -261,6 +264,11 @@
 			//  0xFCC7        (1B)	Mirror of slot 2 secondary slot selection register.
 			//  0xFCC8        (1B)	Mirror of slot 3 secondary slot selection register.
 
+//Hooks
+#define H_KEYI	0xFD9A		//(5B)	Hook at the start of the interrupt routine (all interrupts)
+#define H_TIMI	0xFD9F		//(5B)	Hook of the VDP interrupt routine. Input: A = status register S#0
+
+
 #define RG08SAV   0xFFE7    //Content of VDP(09) register (R#08)
 #define RG09SAV   0xFFE8    //Content of VDP(10) register (R#09)
 #define RG10SAV   0xFFE9    //Content of VDP(11) register (R#10)
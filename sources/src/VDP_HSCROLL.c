@@ -0,0 +1,165 @@
+/* ==============================================================================                                                                            
+# VDP_HSCROLL MSX Library (fR3eL Project)
+
+- Version: 1.1 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Smooth horizontal scroll (1 pixel) with pre-shifted tiles in Graphic2 mode.
+Each pair of tiles (left, right) generates 8 tiles with the pair moved 
+0 to 7 pixels. The name table contains the first tile of each pair, and 
+HScrollBand adds the shift of the current frame while writing a band of rows.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.1 (17/10/2026) Outside Graphic2 (M3=0) only the first bank of the patterns 
+                    is written, and no colors.
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_HSCROLL.h"
+
+
+
+char HSCROLL_buffer[64];
+
+
+
+void HSCROLL_CopyToBanks(unsigned int vaddr);
+
+
+
+/* =============================================================================
+BuildShiftedPair
+Description: 
+		Generates the 8 shifted tiles of a pair and writes them (patterns 
+		and colors) to the banks of the Graphic2 mode (one bank in 
+		GRAPHIC2_MASKED mode). 
+		In Graphic1 mode it only writes the patterns: the color table has 
+		one byte for each group of 8 patterns.
+		Writes 128 bytes per bank: build one pair per frame if the display 
+		is enabled.
+Input:	[const SHIFT_PAIR*] pair
+Output:	-
+============================================================================= */
+void BuildShiftedPair(const SHIFT_PAIR* pair)
+{
+	char shift;
+	char line;
+	char* buffer = HSCROLL_buffer;
+	unsigned int offset = pair->tile << 3;
+	
+	for (shift = 0; shift < 8; shift++)
+	{
+		for (line = 0; line < 8; line++)
+		{
+			if (shift == 0) *buffer++ = pair->left[line];
+			else *buffer++ = (pair->left[line] << shift) | (pair->right[line] >> (8 - shift));
+		}
+	}
+	HSCROLL_CopyToBanks(GetVRAMlayout()->pat + offset);
+	
+	if (!(*(char*) RG0SAV & 0b00000010)) return;	//M3=0 not Graphic2: no color per line
+	
+	buffer = HSCROLL_buffer;
+	for (shift = 0; shift < 8; shift++)
+	{
+		for (line = 0; line < 8; line++) *buffer++ = pair->color[line];
+	}
+	HSCROLL_CopyToBanks(GetVRAMlayout()->col + offset);
+}
+
+
+
+/* =============================================================================
+HSCROLL_CopyToBanks
+Description: 
+		Copies the buffer (8 tiles) to the three banks of the table in 
+		Graphic2 mode, or to the first bank when the mask bits of R#4 are 0 
+		(GRAPHIC2_MASKED) or in the other modes.
+Input:	[unsigned int] VRAM address in the first bank
+Output:	-
+============================================================================= */
+void HSCROLL_CopyToBanks(unsigned int vaddr)
+{
+	CopyToVRAM((unsigned int) HSCROLL_buffer, vaddr, 64);
+	if ((*(char*) RG0SAV & 0b00000010) && (*(char*) (RG0SAV + 4) & 0x03))	//M3=1 Graphic2 with 3 banks
+	{
+		CopyToVRAM((unsigned int) HSCROLL_buffer, vaddr + BANK1, 64);
+		CopyToVRAM((unsigned int) HSCROLL_buffer, vaddr + BANK2, 64);
+	}
+}
+
+
+
+/* =============================================================================
+HScrollBand
+Description: 
+		Writes a band of rows of the name table, adding the shift (0-7) to 
+		each tile. The band contains the first tile of the pairs.
+		Cost: 46 T-states per byte (32 per row) plus about 150.
+Input:	[const char*] band (rows x 32 tiles)
+		[char] first row of the screen
+		[char] number of rows
+		[char] shift (0-7)
+Output:	-
+============================================================================= */
+void HScrollBand(const char* band, char row, char rows, char shift)
+{
+band;	//HL
+row;	//Stack
+rows;	//Stack
+shift;	//Stack
+__asm
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	push HL
+	ld   HL,#4
+	add  HL,SP
+	ld   E,(HL)				//row
+	inc  HL
+	ld   D,(HL)				//rows
+	inc  HL
+	ld   C,(HL)				//shift
+
+	ld   L,E
+	ld   H,#0
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL				//row x 32
+	ld   A,(#_VDP_Layout)
+	add  A,L
+	ld   L,A
+	ld   A,(#_VDP_Layout+1)
+	adc  A,H
+	ld   H,A
+	call _SetVDPtoWRITE
+
+	pop  HL					//band
+	ld   A,D
+	or   A
+	jr   Z,HSCROLL_END$
+HSCROLL_ROWloop$:
+	ld   B,#32
+HSCROLL_loop$:
+	ld   A,(HL)				//( 8ts)
+	add  A,C				//( 5ts) + shift
+	out  (VDPVRAM),A		//(12ts)
+	inc  HL					//( 7ts)
+	djnz HSCROLL_loop$		//(14ts) 46ts
+	dec  D
+	jr   NZ,HSCROLL_ROWloop$
+HSCROLL_END$:
+__endasm;
+}
@@ -0,0 +1,323 @@
+/* ==============================================================================                                                                            
+# VDP_ISR MSX Library (fR3eL Project)
+
+- Version: 1.2 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: MSX-DOS or ROM with RAM in page 0
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Interrupt routine (IM1) of the VDP.
+Replaces the BIOS interrupt routine, so the VRAM updates (OAM, name table, 
+VRAM queue) start at the beginning of the vertical retrace, instead of 
+after the keyboard scan and the hooks of the BIOS.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.2 (17/10/2026) Fix SetISRchain: the functions of the list are called 
+                    from the H.TIMI hook, after the BIOS reads S#0. Before 
+                    S#0 was read, the EI of the VRAM functions re-entered 
+                    the interrupt.
+- v1.1 (17/10/2026) Fix SetISRchain: VDP_ISR does not read S#0 when it jumps 
+                    to the BIOS routine, so the BIOS executes H.TIMI, the 
+                    keyboard scan and the JIFFY increment.
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_ISR.h"
+
+
+
+#define ISR_VECTOR	0x0038
+
+
+
+void (*ISR_callbacks[ISR_CALLBACKS])(void);
+char ISR_count;
+char ISR_chain;
+char ISR_old[3];	//previous instruction at 0x0038 (JP)
+char ISR_oldhook[5];	//copy of the previous H.TIMI hook (SetISRchain)
+
+
+
+/* =============================================================================
+InstallISR
+Description: 
+		Replaces the interrupt routine at 0x0038 with VDP_ISR.
+		Requires RAM in page 0 (MSX-DOS or 64K RAM configurations).
+		In a ROM with its own page 0, put a JP VDP_ISR at 0x0038 instead.
+		VDP_ISR reads S#0, saves it in STATFL, increments JIFFY and calls 
+		the functions added with AddISRcallback. 
+		The BIOS routine (keyboard, H.TIMI hook...) is not executed unless 
+		it is enabled with SetISRchain (see SetISRchain).
+		Empties the list of functions: add them after InstallISR.
+Input:	-
+Output:	-
+============================================================================= */
+void InstallISR(void) __naked
+{
+__asm
+	di
+	ld   HL,#ISR_VECTOR
+	ld   DE,#_ISR_old
+	ld   BC,#3
+	ldir					//save the previous routine
+
+	ld   A,#0xC3			//JP
+	ld   (#ISR_VECTOR),A
+	ld   HL,#VDP_ISR
+	ld   (#ISR_VECTOR+1),HL
+
+	xor  A
+	ld   (#_ISR_count),A
+	ld   (#_ISR_chain),A
+	ei
+	ret
+
+
+
+/* =============================================================================
+VDP_ISR
+Description: 
+		Interrupt routine. 
+		With the interrupts disabled: reads S#0, and if it is the VDP 
+		interrupt, saves it in STATFL, increments JIFFY and calls the 
+		functions of the list.
+		With SetISRchain(1), it jumps to the previous routine without 
+		reading S#0: the BIOS reads it and does the rest of the work 
+		(STATFL, JIFFY, H.TIMI, keyboard...). The functions of the list 
+		are called from the H.TIMI hook (ISR_HOOK$).
+Regs:	-
+============================================================================= */
+VDP_ISR::
+	push AF
+	ld   A,(#_ISR_chain)
+	or   A
+	jr   NZ,ISR_CHAIN$
+
+	in   A,(VDPSTATUS)		//S#0. Clears the interrupt
+	or   A
+	jp   P,ISR_END$			//F=0, not from the VDP
+	ld   (#STATFL),A
+
+	push HL
+	ld   HL,(#JIFFY)
+	inc  HL
+	ld   (#JIFFY),HL
+	pop  HL
+
+	call ISR_RUN$
+
+ISR_END$:
+	pop  AF
+	ei
+	ret
+
+//the BIOS routine reads S#0 (the F flag is still set)
+ISR_CHAIN$:
+	pop  AF
+	jp   _ISR_old			//previous routine
+
+
+
+/* --------------------------------------------------------------------------
+H.TIMI hook (SetISRchain)
+The BIOS has read S#0 (A) and saved it in STATFL: the interrupt is cleared.
+-------------------------------------------------------------------------- */
+ISR_HOOK$:
+	push AF
+	call ISR_RUN$
+	pop  AF
+	jp   _ISR_oldhook		//previous hook
+
+
+
+/* --------------------------------------------------------------------------
+Calls the functions of the list
+Regs:	A
+-------------------------------------------------------------------------- */
+ISR_RUN$:
+	ld   A,(#_ISR_count)
+	or   A
+	ret  Z
+
+	push BC
+	push DE
+	push HL
+	push IX
+	push IY
+	ex   AF,AF
+	push AF
+
+	ld   A,(#_ISR_count)
+	ld   B,A
+	ld   HL,#_ISR_callbacks
+ISR_loop$:
+	ld   E,(HL)
+	inc  HL
+	ld   D,(HL)
+	inc  HL
+	push BC
+	push HL
+	ex   DE,HL
+	call ISR_CALL$
+	pop  HL
+	pop  BC
+	djnz ISR_loop$
+
+	pop  AF
+	ex   AF,AF
+	pop  IY
+	pop  IX
+	pop  HL
+	pop  DE
+	pop  BC
+	ret
+
+ISR_CALL$:
+	jp   (HL)
+__endasm;
+}
+
+
+
+/* =============================================================================
+RemoveISR
+Description: 
+		Restores the previous interrupt routine at 0x0038 and, if 
+		SetISRchain is enabled, the previous H.TIMI hook.
+Input:	-
+Output:	-
+============================================================================= */
+void RemoveISR(void) __naked
+{
+__asm
+	xor  A
+	call _SetISRchain
+	di
+	ld   HL,#_ISR_old
+	ld   DE,#ISR_VECTOR
+	ld   BC,#3
+	ldir
+	ei
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+AddISRcallback
+Description: 
+		Adds a function to the list that VDP_ISR calls at the start of the 
+		vertical retrace, in the order they were added (up to ISR_CALLBACKS).
+		They are called with the interrupts disabled and S#0 already read, 
+		but the VRAM functions of the library enable them (EI) when they 
+		end: the functions of the list must end before the next interrupt.
+Input:	[void (*)(void)] function
+Output:	[char] 1 = added; 0 = the list is full
+============================================================================= */
+char AddISRcallback(void (*callback)(void))
+{
+	if (ISR_count == ISR_CALLBACKS) return 0;
+	
+	__asm__("di");
+	ISR_callbacks[ISR_count] = callback;
+	ISR_count++;
+	__asm__("ei");
+	return 1;
+}
+
+
+
+/* =============================================================================
+ClearISRcallbacks
+Description: 
+		Empties the list of functions.
+Input:	-
+Output:	-
+============================================================================= */
+void ClearISRcallbacks(void)
+{
+	ISR_count = 0;
+}
+
+
+
+/* =============================================================================
+SetISRchain
+Description: 
+		Enables or disables the jump to the previous interrupt routine. 
+		With the jump enabled, VDP_ISR does not read S#0: the BIOS routine 
+		reads it, saves it in STATFL and executes H.TIMI, the keyboard scan 
+		and the JIFFY increment as usual. The functions of the list are 
+		called from the H.TIMI hook, before the keyboard scan.
+		The previous hook is called after them. If other hooks are 
+		installed in H.TIMI (EnableVQueueHook...), remove them in the 
+		reverse order.
+		Keeps the interrupt state of the caller.
+Input:	[char] 0 = no; 1 = jump to the previous routine
+Output:	-
+============================================================================= */
+void SetISRchain(char chain) __naked
+{
+chain;	//A
+__asm
+	ld   C,A
+	ld   A,I
+	jp   PE,ISR_SETiff$
+	ld   A,I				//NMOS Z80: P/V=0 if an interrupt was accepted in the first LD A,I
+ISR_SETiff$:
+	push AF					//P/V = IFF2
+	di
+
+	ld   A,C
+	ld   (#_ISR_chain),A
+
+//installed = H.TIMI has JP ISR_HOOK$ (does not depend on the RAM at startup)
+	ld   HL,(#H_TIMI+1)
+	ld   DE,#ISR_HOOK$
+	or   A
+	sbc  HL,DE
+	jr   NZ,ISR_SETnew$
+	ld   A,(#H_TIMI)
+	cp   #0xC3				//JP
+	jr   NZ,ISR_SETnew$
+
+	ld   A,C
+	or   A
+	jr   NZ,ISR_SETend$		//the hook is already installed
+	ld   HL,#_ISR_oldhook
+	ld   DE,#H_TIMI
+	ld   BC,#5
+	ldir					//restore the previous hook
+	jr   ISR_SETend$
+
+ISR_SETnew$:
+	ld   A,C
+	or   A
+	jr   Z,ISR_SETend$		//the hook is not installed
+	ld   HL,#H_TIMI
+	ld   DE,#_ISR_oldhook
+	ld   BC,#5
+	ldir					//save the previous hook
+	ld   A,#0xC3			//JP
+	ld   (#H_TIMI),A
+	ld   HL,#ISR_HOOK$
+	ld   (#H_TIMI+1),HL
+
+ISR_SETend$:
+	pop  AF
+	ret  PO					//the interrupts were disabled
+	ei
+	ret
+__endasm;
+}
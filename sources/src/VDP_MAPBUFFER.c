@@ -0,0 +1,186 @@
+/* ==============================================================================                                                                            
+# VDP_MAPBUFFER MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Pattern Name Table buffer in RAM.
+The tiles are written in RAM and only the modified rows are sent to VRAM. 
+Consecutive modified rows are sent in a single block.
+With SetBackMap/FlipMap, it also sends to the new back table the rows 
+modified since it was last written.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.1 (17/10/2026) FlushMapBuffer follows the FlipMap swaps (MAP_pending).
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_MAPBUFFER.h"
+
+
+
+char MapBuffer[MAPBUFFER_SIZE];
+
+char MAP_dirty[3];			//one bit per row
+char MAP_pending[3];		//rows that the other name table lacks (double buffering)
+unsigned int MAP_lastMap;	//name table of the last FlushMapBuffer
+char MAP_width;				//32 or 40
+unsigned int MAP_row[MAPBUFFER_ROWS];	//offset of each row
+
+const char MAP_bit[8] = {1,2,4,8,16,32,64,128};
+
+
+
+/* =============================================================================
+InitMapBuffer
+Description: 
+		Initializes the buffer for the current screen mode (name table 
+		address and row width) and fills it with 0, like SCREEN and CLS.
+		Call it after SCREEN.
+Input:	-
+Output:	-
+============================================================================= */
+void InitMapBuffer(void)
+{
+	char row;
+	unsigned int offset = 0;
+	char reg1 = *(char*) RG1SAV;
+	unsigned int i;
+	
+	if (reg1 & 0b00010000) MAP_width = 40;	//M1=1 Text1
+	else MAP_width = 32;
+
+	
+	for (row = 0; row < MAPBUFFER_ROWS; row++)
+	{
+		MAP_row[row] = offset;
+		offset += MAP_width;
+	}
+	
+	for (i = 0; i < MAPBUFFER_SIZE; i++) MapBuffer[i] = 0;
+	
+	MAP_dirty[0] = 0;
+	MAP_dirty[1] = 0;
+	MAP_dirty[2] = 0;
+	
+	MAP_pending[0] = 0;
+	MAP_pending[1] = 0;
+	MAP_pending[2] = 0;
+	MAP_lastMap = GetVRAMlayout()->map;
+}
+
+
+
+/* =============================================================================
+SetMapTile
+Description: 
+		Writes a tile in the buffer and marks its row as modified.
+Input:	[char] column
+		[char] row (0-23)
+		[char] tile number
+Output:	-
+============================================================================= */
+void SetMapTile(char column, char row, char tile)
+{
+	MapBuffer[MAP_row[row] + column] = tile;
+	MAP_dirty[row >> 3] |= MAP_bit[row & 7];
+}
+
+
+
+/* =============================================================================
+GetMapTile
+Description: 
+		Reads a tile from the buffer.
+Input:	[char] column
+		[char] row (0-23)
+Output:	[char] tile number
+============================================================================= */
+char GetMapTile(char column, char row)
+{
+	return MapBuffer[MAP_row[row] + column];
+}
+
+
+
+/* =============================================================================
+SetMapRowDirty
+Description: 
+		Marks a row of the buffer as modified, to be sent by FlushMapBuffer.
+Input:	[char] row (0-23)
+Output:	-
+============================================================================= */
+void SetMapRowDirty(char row)
+{
+	MAP_dirty[row >> 3] |= MAP_bit[row & 7];
+}
+
+
+
+/* =============================================================================
+FlushMapBuffer
+Description: 
+		Sends the modified rows to the Pattern Name Table. 
+		Consecutive rows are sent in a single block.
+		If the name table has changed since the last call (FlipMap), it also 
+		sends the rows that were sent to the other table since this one was 
+		last written.
+Input:	-
+Output:	-
+============================================================================= */
+void FlushMapBuffer(void)
+{
+	VRAM_BLOCK block;
+	char send[3];
+	char row = 0;
+	char first;
+	char i;
+	unsigned int map = GetVRAMlayout()->map;
+	
+	for (i = 0; i < 3; i++)
+	{
+		if (map != MAP_lastMap)
+		{
+			send[i] = MAP_dirty[i] | MAP_pending[i];
+			MAP_pending[i] = MAP_dirty[i];		//the previous table lacks only this frame
+		}
+		else
+		{
+			send[i] = MAP_dirty[i];
+			MAP_pending[i] |= MAP_dirty[i];
+		}
+		MAP_dirty[i] = 0;
+	}
+	MAP_lastMap = map;
+	
+	if ((send[0] | send[1] | send[2]) == 0) return;
+	
+	while (row < MAPBUFFER_ROWS)
+	{
+		if (!(send[row >> 3] & MAP_bit[row & 7]))
+		{
+			row++;
+			continue;
+		}
+		
+		first = row;
+		while (row < MAPBUFFER_ROWS && (send[row >> 3] & MAP_bit[row & 7])) row++;
+		
+		block.addr = (unsigned int) &MapBuffer[MAP_row[first]];
+		block.vaddr = map + MAP_row[first];
+		block.size = MAP_row[row - 1] + MAP_width - MAP_row[first];
+		CopyToVRAMblock(&block);
+	}
+}
@@ -0,0 +1,218 @@
+/* ==============================================================================                                                                            
+# VDP_MAPDIFF MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Differential dump of the Pattern Name Table buffer.
+Keeps a copy of the values sent to VRAM and only writes the bytes that have 
+changed in the modified rows, with the minimum number of VRAM address setups.
+
+Requires the VDP_TMS9918A and VDP_MAPBUFFER Libraries.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_MAPBUFFER.h"
+#include "../include/VDP_MAPDIFF.h"
+
+
+
+// from VDP_MAPBUFFER
+extern char MAP_dirty[3];
+extern char MAP_width;
+extern unsigned int MAP_row[MAPBUFFER_ROWS];
+extern const char MAP_bit[8];
+
+
+char MAPDIFF_sent[MAPBUFFER_SIZE];	//last values sent to VRAM
+unsigned int MAPDIFF_delta;			//VRAM address - MapBuffer address
+
+
+
+void MAPDIFF_Block(unsigned int offset, unsigned int size);
+
+
+
+/* =============================================================================
+InitMapDiff
+Description: 
+		Copies the buffer (MapBuffer) to the copy of the last values sent 
+		to VRAM. Call it after InitMapBuffer or when the buffer and the VRAM 
+		have the same content.
+Input:	-
+Output:	-
+============================================================================= */
+void InitMapDiff(void) __naked
+{
+__asm
+	ld   HL,#_MapBuffer
+	ld   DE,#_MAPDIFF_sent
+	ld   BC,#MAPBUFFER_SIZE
+	ldir
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+FlushMapDiff
+Description: 
+		Compares the modified rows of the buffer with the last values sent 
+		to VRAM and only writes the bytes that have changed.
+		Runs of changed bytes separated by up to MAPDIFF_GAP unchanged bytes 
+		are written as a single block.
+		Do not mix it with FlushMapBuffer.
+		Only for a single name table: it does not follow the FlipMap swaps 
+		(SetBackMap/FlipMap).
+Input:	-
+Output:	-
+============================================================================= */
+void FlushMapDiff(void)
+{
+	char row = 0;
+	char first;
+	
+	if ((MAP_dirty[0] | MAP_dirty[1] | MAP_dirty[2]) == 0) return;
+	
+	MAPDIFF_delta = GetVRAMlayout()->map - (unsigned int) MapBuffer;
+	
+	while (row < MAPBUFFER_ROWS)
+	{
+		if (!(MAP_dirty[row >> 3] & MAP_bit[row & 7]))
+		{
+			row++;
+			continue;
+		}
+		
+		first = row;
+		while (row < MAPBUFFER_ROWS && (MAP_dirty[row >> 3] & MAP_bit[row & 7])) row++;
+		
+		MAPDIFF_Block(MAP_row[first], MAP_row[row - 1] + MAP_width - MAP_row[first]);
+	}
+	
+	MAP_dirty[0] = 0;
+	MAP_dirty[1] = 0;
+	MAP_dirty[2] = 0;
+}
+
+
+
+/* =============================================================================
+MAPDIFF_Block
+Description: 
+		Compares an area of the buffer with the copy of the values sent and 
+		writes the changed runs to VRAM, updating the copy.
+		Compare: 52 T-states per unchanged byte.
+Input:	[unsigned int] offset in the buffer
+		[unsigned int] size
+Output:	-
+============================================================================= */
+void MAPDIFF_Block(unsigned int offset, unsigned int size) __naked
+{
+offset;	//HL
+size;	//DE
+__asm
+	ld   A,D
+	or   E
+	ret  Z
+
+	ld   B,D
+	ld   C,E				//BC = size
+
+	push HL
+	ld   DE,#_MAPDIFF_sent
+	add  HL,DE
+	ex   (SP),HL			//(SP) = copy address
+	ld   DE,#_MapBuffer
+	add  HL,DE				//HL = buffer address
+	pop  DE					//DE = copy address
+
+//search for the next changed byte
+MAPDIFF_scan$:
+	ld   A,(DE)				//( 8ts)
+	inc  DE					//( 7ts)
+	cpi						//(18ts) cp (HL); inc HL; dec BC
+	jr   NZ,MAPDIFF_found$	//( 8ts)
+	jp   PE,MAPDIFF_scan$	//(11ts) BC<>0
+	ret
+
+MAPDIFF_found$:
+	dec  HL
+	dec  DE
+	inc  BC
+
+//start of a run: set the VRAM address
+	push HL
+	push DE
+	ld   DE,(#_MAPDIFF_delta)
+	add  HL,DE
+	call _SetVDPtoWRITE
+	pop  DE
+	pop  HL
+
+MAPDIFF_write$:
+	ld   A,(HL)
+	ld   (DE),A				//update the copy
+	out  (VDPVRAM),A
+	inc  HL
+	inc  DE
+	dec  BC
+	ld   A,B
+	or   C
+	ret  Z
+
+	ld   A,(DE)
+	cp   (HL)
+	jr   NZ,MAPDIFF_write$	//the run continues
+
+//unchanged byte: is there a change in the next MAPDIFF_GAP bytes?
+	ld   A,B
+	or   A
+	jr   NZ,MAPDIFF_gapfull$
+	ld   A,C
+	cp   #MAPDIFF_GAP+1
+	jr   NC,MAPDIFF_gapfull$
+	dec  A					//bytes after this one
+	ret  Z
+	jr   MAPDIFF_look$
+MAPDIFF_gapfull$:
+	ld   A,#MAPDIFF_GAP
+
+MAPDIFF_look$:
+	push BC
+	push DE
+	push HL
+	ld   B,A
+MAPDIFF_lookloop$:
+	inc  HL
+	inc  DE
+	ld   A,(DE)
+	cp   (HL)
+	jr   NZ,MAPDIFF_near$
+	djnz MAPDIFF_lookloop$
+
+	pop  HL					//no changes: end of the run
+	pop  DE
+	pop  BC
+	jr   MAPDIFF_scan$
+
+MAPDIFF_near$:
+	pop  HL					//write the unchanged bytes (cheaper than a new address)
+	pop  DE
+	pop  BC
+	jr   MAPDIFF_write$
+__endasm;
+}
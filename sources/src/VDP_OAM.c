@@ -0,0 +1,257 @@
+/* ==============================================================================                                                                            
+# VDP_OAM MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Sprite Attribute Table (OAM) buffer in RAM.
+The sprite attributes are modified in RAM and sent to VRAM in a single block, 
+with only one VRAM address setup.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_OAM.h"
+
+
+
+char OAMbuffer[OAM_SIZE];
+
+
+
+/* =============================================================================
+ClearOAM
+Description: 
+		Initialises the RAM buffer of the Sprite Attribute Table.
+		The vertical location of the sprites is set to 209.
+		Does not access the VRAM. Use FlushOAM to display it.
+Input:	-
+Output:	-
+============================================================================= */
+void ClearOAM(void) __naked
+{
+__asm
+	ld   HL,#_OAMbuffer
+	ld   B,#32
+	xor  A
+OAM_Clearloop$:
+	ld   (HL),#SPRITES_YHIDDEN	//Y
+	inc  HL
+	ld   (HL),A					//X
+	inc  HL
+	ld   (HL),A					//pattern
+	inc  HL
+	ld   (HL),A					//color
+	inc  HL
+	djnz OAM_Clearloop$
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+SetOAMposition
+Description: 
+		Sets the position of a sprite in the RAM buffer.
+Input:	[char] sprite plane (0-31) 
+		[char] X coordinate 
+		[char] Y coordinate
+Output:	-
+============================================================================= */
+void SetOAMposition(char plane, char x, char y)
+{
+plane;	//A
+x;		//L
+y;		//Stack
+__asm
+	ld   C,L		//x
+
+	call GetOAMbufferADDR	//Input: A<--plane; Output: HL-->RAM address
+	ex   DE,HL
+
+	ld   HL,#2
+	add  HL,SP
+	ld   A,(HL)		//y
+	ld   (DE),A
+	inc  DE
+	ld   A,C
+	ld   (DE),A		//x
+__endasm;
+}
+
+
+
+/* =============================================================================
+SetOAMpattern
+Description: 
+		Sets the pattern of a sprite in the RAM buffer.
+		In 16x16 mode the value is multiplied by 4, like PUTSPRITE.
+Input:	[char] sprite plane (0-31) 
+		[char] pattern number
+Output:	-
+============================================================================= */
+void SetOAMpattern(char plane, char pattern) __naked
+{
+plane;		//A
+pattern;	//L
+__asm
+	ld   C,L
+
+	call GetOAMbufferADDR	//Input: A<--plane; Output: HL-->RAM address
+	inc  HL
+	inc  HL
+
+	ld   E,C
+	call GetSpritePattern	//Input: E<--Sprite pattern; Output: A-->pattern position
+	ld   (HL),A
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+SetOAMcolor
+Description: 
+		Sets the color of a sprite in the RAM buffer.
+Input:	[char] sprite plane (0-31) 
+		[char] color (0-15) + Early Clock bit (128)
+Output:	-
+============================================================================= */
+void SetOAMcolor(char plane, char color) __naked
+{
+plane;	//A
+color;	//L
+__asm
+	ld   C,L
+
+	call GetOAMbufferADDR	//Input: A<--plane; Output: HL-->RAM address
+	inc  HL
+	inc  HL
+	inc  HL
+
+	ld   (HL),C
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+PutSpriteOAM
+Description: 
+		Same as PUTSPRITE, but only writes to the RAM buffer.
+Input:	[char] sprite plane (0-31) 
+		[char] X coordinate 
+		[char] Y coordinate
+		[char] color (0-15)
+		[char] pattern number
+Output:	-
+============================================================================= */
+void PutSpriteOAM(char plane, char x, char y, char color, char pattern)
+{
+plane;		//A
+x;			//L
+y;			//Stack
+color;		//Stack
+pattern;	//Stack
+__asm
+	ld   C,L		//x
+
+	call GetOAMbufferADDR	//Input: A<--plane; Output: HL-->RAM address
+	ex   DE,HL
+
+	ld   HL,#2
+	add  HL,SP
+	ld   A,(HL)		//y
+	ld   (DE),A
+	inc  DE
+
+	ld   A,C
+	ld   (DE),A		//x
+	inc  DE
+
+	inc  HL
+	ld   B,(HL)		//color
+	inc  HL
+	ld   A,(HL)		//Sprite pattern
+	ex   DE,HL
+	ld   E,A
+	call GetSpritePattern	//Input: E; Output: A pattern position according to sprite size
+	ld   (HL),A
+	inc  HL
+
+	ld   (HL),B		//color
+__endasm;
+}
+
+
+
+/* =============================================================================
+FlushOAM
+Description: 
+		Dumps the RAM buffer to the Sprite Attribute Table (VDP_Layout.oam) in a 
+		single block (one VRAM address setup).
+Input:	-
+Output:	-
+============================================================================= */
+void FlushOAM(void) __naked
+{
+__asm
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout+6)	//Sprite Attribute Table
+	ld   DE,#_OAMbuffer
+	ld   BC,#OAM_SIZE
+	jp   LDIR2VRAM			//Input: HL-->VRAM addr; DE-->RAM addr; BC-->size
+
+
+/* =============================================================================
+fastFlushOAM
+Description: 
+		Same as FlushOAM without the 29 T-states pacing.
+		Only when the display is disabled (BLK=0) or during vertical retrace.
+Input:	-
+Output:	-
+Regs:	A, BC, DE, HL
+============================================================================= */
+fastFlushOAM::
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout+6)	//Sprite Attribute Table
+	ld   DE,#_OAMbuffer
+	ld   BC,#OAM_SIZE
+	jp   fastLDIR2VRAM
+
+
+
+/* =============================================================================
+GetOAMbufferADDR
+Description:
+		Gets the RAM address of the attributes of a sprite plane in the buffer.
+Input:	A  - sprite plane (0-31)
+Output:	HL - RAM address
+Regs:	DE
+============================================================================= */
+GetOAMbufferADDR::
+	add  A
+	add  A				//multiply x 4
+	ld   E,A
+	ld   D,#0
+	ld   HL,#_OAMbuffer
+	add  HL,DE
+	ret
+__endasm;
+}
@@ -0,0 +1,147 @@
+/* ==============================================================================                                                                            
+# VDP_PROFILE MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Border colour profiler (raster bars).
+Each section of code shows its own border colour while it is executed, so 
+the time it spends in the frame can be seen on the screen.
+The sections can be nested: when one ends, the border returns to the colour 
+of the section that contains it.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_PROFILE.h"
+
+
+
+char PROFILE_stack[PROFILE_DEPTH];	//colours of the open sections
+char PROFILE_depth;
+
+
+
+/* =============================================================================
+ProfileBegin
+Description: 
+		Starts a section of code: changes the border colour.
+		Writes directly in VDP register 7 (one register write), without 
+		updating the system variables.
+		In SCREEN 0 it changes the background colour.
+Input:	[char] colour of the section (0-15)
+Output:	-
+============================================================================= */
+void ProfileBegin(char color) __naked
+{
+	color;	//A
+__asm
+	and  #0x0F
+	ld   C,A
+
+	ld   A,(#_PROFILE_depth)
+	cp   #PROFILE_DEPTH
+	jr   NC,PROFILE_NEXT$		//too many levels: not saved
+	ld   E,A
+	ld   D,#0
+	ld   HL,#_PROFILE_stack
+	add  HL,DE
+	ld   (HL),C
+
+PROFILE_NEXT$:
+	inc  A
+	ld   (#_PROFILE_depth),A
+
+	ld   A,(#RG7SAV)			//ink of SCREEN 0
+	and  #0xF0
+	or   C
+
+
+
+/* --------------------------------------------------------------------------
+Writes in VDP register 7, without updating RG7SAV
+Input:	A - value
+Regs:	-
+-------------------------------------------------------------------------- */
+PROFILE_SetR7$:
+	di
+	out  (VDPSTATUS),A
+	ld   A,#0x87				//VDP reg 7 + 128
+	ei						//interrupts are enabled after the next instruction
+	out  (VDPSTATUS),A
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ProfileEnd
+Description: 
+		Ends the last section started: restores the colour of the section 
+		that contains it, or the colour of the COLOR function.
+Input:	-
+Output:	-
+============================================================================= */
+void ProfileEnd(void) __naked
+{
+__asm
+	ld   A,(#_PROFILE_depth)
+	or   A
+	ret  Z						//no open sections
+	dec  A
+	ld   (#_PROFILE_depth),A
+	jr   Z,PROFILE_COLOR$
+
+	dec  A						//level of the section that contains it
+	cp   #PROFILE_DEPTH
+	jr   C,PROFILE_PREV$
+	ld   A,#PROFILE_DEPTH-1		//not saved: the last one saved
+
+PROFILE_PREV$:
+	ld   E,A
+	ld   D,#0
+	ld   HL,#_PROFILE_stack
+	add  HL,DE
+	ld   A,(#RG7SAV)
+	and  #0xF0
+	or   (HL)
+	jp   PROFILE_SetR7$
+
+PROFILE_COLOR$:
+	ld   A,(#RG7SAV)			//colour of the COLOR function
+	jp   PROFILE_SetR7$
+__endasm;
+}
+
+
+
+/* =============================================================================
+ResetProfile
+Description: 
+		Closes all the sections and restores the colour of the COLOR function.
+		Call it at the start of the program, after COLOR/SCREEN.
+Input:	-
+Output:	-
+============================================================================= */
+void ResetProfile(void) __naked
+{
+__asm
+	xor  A
+	ld   (#_PROFILE_depth),A
+	jp   PROFILE_COLOR$
+__endasm;
+}
@@ -0,0 +1,697 @@
+/* ==============================================================================                                                                            
+# VDP_QUEUE MSX Library (fR3eL Project)
+
+- Version: 1.3 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Deferred VRAM command queue.
+Copy, fill, poke and register commands are stored in a ring buffer in RAM 
+and executed in the vertical retrace (H.TIMI hook) with the unpaced VRAM 
+access of the VDP_TMS9918A Library, up to a byte budget per frame.
+Large transfers can also be started as resumable transfers that advance with 
+the budget left in each frame.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.3 (17/10/2026) The interrupt state is read twice (LD A,I of the NMOS Z80).
+                    EnableVQueueHook and DisableVQueueHook keep the interrupt 
+                    state. DrainVQueue is not re-entered by the interrupt.
+- v1.2 (17/10/2026) Cost per command in the budget, lower default budgets, PauseVQueue and ResumeVQueue
+- v1.1 (17/10/2026) Added resumable transfers and budgets for 50/60Hz
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_QUEUE.h"
+
+
+
+// Commands
+#define VQ_COPY	1
+#define VQ_FILL	2
+#define VQ_POKE	3
+#define VQ_REG	4
+
+
+
+// Queue entry (8 bytes). The offsets are used by DrainVQueue.
+// VRAM_TRANSFER has the same layout plus the link to the next transfer.
+typedef struct {
+	char op;			//0 command
+	char value;			//1 fill/poke/register value
+	unsigned int vaddr;	//2 VRAM address or register number
+	unsigned int size;	//4 block size
+	unsigned int addr;	//6 Memory address
+} VQ_ENTRY;
+
+
+
+VQ_ENTRY VQ_buffer[VQUEUE_SIZE];
+volatile char VQ_head;		//next command to execute (interrupt)
+volatile char VQ_tail;		//next free entry (program)
+
+VRAM_TRANSFER* VQ_transfers;	//running transfers
+
+volatile char VQ_paused;	//1 = the hook does not execute the queue
+char VQ_busy;				//1 = DrainVQueue is running
+
+char VQ_pal;				//1 = 50Hz
+unsigned int VQ_budget;		//bytes per frame
+unsigned int VQ_left;		//bytes left in the current frame
+
+char VQ_oldhook[5];			//copy of the previous H.TIMI hook
+
+
+
+char VQ_Push(char op, char value, unsigned int vaddr, unsigned int size, unsigned int addr);
+char VQ_GetFreq(void);
+void VQ_AddTransfer(VRAM_TRANSFER* transfer);
+
+
+
+/* =============================================================================
+InitVQueue
+Description: 
+		Initializes the queue (empty), resumes it (ResumeVQueue) and sets the 
+		byte budget per frame according to the interrupt frequency of the 
+		computer (50/60Hz).
+Input:	-
+Output:	-
+============================================================================= */
+void InitVQueue(void)
+{
+	VQ_head = 0;
+	VQ_tail = 0;
+	VQ_transfers = 0;
+	VQ_paused = 0;
+	VQ_busy = 0;
+	
+	VQ_pal = (VQ_GetFreq() & 0b10000000) ? 1 : 0;
+	SetVQueueBudgets(VQUEUE_BUDGET_NTSC, VQUEUE_BUDGET_PAL);
+}
+
+
+
+/* =============================================================================
+SetVQueueBudget
+Description: 
+		Sets the maximum number of bytes written to VRAM in each call to 
+		DrainVQueue. A copy or fill bigger than the remaining budget is 
+		continued in the next frame.
+Input:	[unsigned int] bytes per frame
+Output:	-
+============================================================================= */
+void SetVQueueBudget(unsigned int size)
+{
+	VQ_budget = size;
+}
+
+
+
+/* =============================================================================
+SetVQueueBudgets
+Description: 
+		Sets the bytes per frame for 60Hz and 50Hz computers.
+		The value is chosen according to the interrupt frequency of the 
+		computer.
+Input:	[unsigned int] bytes per frame at 60Hz (NTSC)
+		[unsigned int] bytes per frame at 50Hz (PAL)
+Output:	-
+============================================================================= */
+void SetVQueueBudgets(unsigned int ntsc, unsigned int pal)
+{
+	if (VQ_pal) VQ_budget = pal;
+	else VQ_budget = ntsc;
+}
+
+
+
+/* =============================================================================
+QueueCopyToVRAM
+Description: 
+		Adds a block transfer from memory to VRAM to the queue.
+		The memory block must not be modified until the transfer is done.
+Input:	[unsigned int] Memory address
+		[unsigned int] VRAM address
+		[unsigned int] block size
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueCopyToVRAM(unsigned int addr, unsigned int vaddr, unsigned int size)
+{
+	return VQ_Push(VQ_COPY, 0, vaddr, size, addr);
+}
+
+
+
+/* =============================================================================
+QueueFillVRAM
+Description: 
+		Adds a fill of an area of VRAM to the queue.
+Input:	[unsigned int] VRAM address
+		[unsigned int] block size
+		[char] Value to fill
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueFillVRAM(unsigned int vaddr, unsigned int size, char value)
+{
+	return VQ_Push(VQ_FILL, value, vaddr, size, 0);
+}
+
+
+
+/* =============================================================================
+QueueVPOKE
+Description: 
+		Adds the write of a value to VRAM to the queue.
+Input:	[unsigned int] VRAM address
+		[char] value
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueVPOKE(unsigned int vaddr, char value)
+{
+	return VQ_Push(VQ_POKE, value, vaddr, 1, 0);
+}
+
+
+
+/* =============================================================================
+QueueSetVDP
+Description: 
+		Adds the write of a VDP register to the queue.
+		The system variable of the register is updated when it is executed.
+Input:	[char] register number (0-7)
+		[char] value
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char QueueSetVDP(char reg, char value)
+{
+	return VQ_Push(VQ_REG, value, reg, 1, 0);
+}
+
+
+
+/* =============================================================================
+StartVRAMtransfer
+Description: 
+		Starts a block transfer from memory to VRAM that advances in each 
+		DrainVQueue with the budget left by the queue commands, until it is 
+		completed. Several transfers are executed in order of start.
+		Do not start again a transfer that is not done.
+Input:	[VRAM_TRANSFER*] transfer handle
+		[unsigned int] Memory address
+		[unsigned int] VRAM address
+		[unsigned int] block size
+Output:	-
+============================================================================= */
+void StartVRAMtransfer(VRAM_TRANSFER* transfer, unsigned int addr, unsigned int vaddr, unsigned int size)
+{
+	transfer->op = VQ_COPY;
+	transfer->vaddr = vaddr;
+	transfer->size = size;
+	transfer->addr = addr;
+	transfer->next = 0;
+	
+	if (size == 0) return;
+	
+	VQ_AddTransfer(transfer);
+}
+
+
+
+/* =============================================================================
+IsVRAMtransferDone
+Description: 
+		Indicates if a transfer has been completed.
+Input:	[VRAM_TRANSFER*] transfer handle
+Output:	[char] 1 = done; 0 = running
+============================================================================= */
+char IsVRAMtransferDone(VRAM_TRANSFER* transfer) __naked
+{
+transfer;	//HL
+__asm
+	ld   DE,#4
+	add  HL,DE				//size
+
+//the size is decremented by the interrupt: the two bytes are read with DI
+	ld   A,I				//P/V = IFF2
+	jp   PE,VQ_DONEei$
+	ld   A,I				//NMOS Z80: P/V=0 if an interrupt was accepted in the first LD A,I
+	jp   PE,VQ_DONEei$
+
+	ld   E,(HL)				//the interrupts were disabled
+	inc  HL
+	ld   D,(HL)
+	jr   VQ_DONEtest$
+
+VQ_DONEei$:
+	di
+	ld   E,(HL)
+	inc  HL
+	ld   D,(HL)
+	ei
+
+VQ_DONEtest$:
+
+	ld   A,D
+	or   E
+	ld   A,#0
+	ret  NZ					//running
+	inc  A					//done
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+IsVQueueEmpty
+Description: 
+		Indicates if all the commands of the queue have been executed.
+Input:	-
+Output:	[char] 1 = empty; 0 = pending commands
+============================================================================= */
+char IsVQueueEmpty(void)
+{
+	return VQ_head == VQ_tail;
+}
+
+
+
+/* =============================================================================
+VQ_Push
+Description: 
+		Writes a command in the next free entry and publishes it.
+		The tail index is updated last, so the interrupt never sees an 
+		incomplete entry.
+Input:	[char] command
+		[char] value
+		[unsigned int] VRAM address or register number
+		[unsigned int] block size
+		[unsigned int] Memory address
+Output:	[char] 1 = queued; 0 = the queue is full
+============================================================================= */
+char VQ_Push(char op, char value, unsigned int vaddr, unsigned int size, unsigned int addr)
+{
+	VQ_ENTRY* entry;
+	char next = (VQ_tail + 1) & (VQUEUE_SIZE - 1);
+	
+	if (size == 0) return 1;			//nothing to do
+	if (next == VQ_head) return 0;		//full
+	
+	entry = &VQ_buffer[VQ_tail];
+	entry->op = op;
+	entry->value = value;
+	entry->vaddr = vaddr;
+	entry->size = size;
+	entry->addr = addr;
+	
+	VQ_tail = next;
+	return 1;
+}
+
+
+
+/* =============================================================================
+VQ_AddTransfer
+Description: 
+		Adds a transfer to the end of the list of running transfers.
+		The list is also modified by the interrupt: it is changed with DI 
+		and the previous interrupt state is restored.
+Input:	[VRAM_TRANSFER*] transfer handle
+Output:	-
+============================================================================= */
+void VQ_AddTransfer(VRAM_TRANSFER* transfer) __naked
+{
+transfer;	//HL
+__asm
+	ld   A,I				//P/V = IFF2
+	jp   PE,VQ_ADDiff$
+	ld   A,I				//NMOS Z80: P/V=0 if an interrupt was accepted in the first LD A,I
+VQ_ADDiff$:
+	push AF
+	di
+
+	ex   DE,HL				//DE = transfer
+	ld   HL,#_VQ_transfers
+VQ_ADDloop$:
+	ld   A,(HL)
+	inc  HL
+	or   (HL)
+	jr   Z,VQ_ADDlast$		//null pointer: end of the list
+	ld   A,(HL)
+	dec  HL
+	ld   L,(HL)
+	ld   H,A				//HL = transfer
+	ld   BC,#8
+	add  HL,BC				//HL = pointer to the next transfer
+	jr   VQ_ADDloop$
+
+VQ_ADDlast$:
+	ld   (HL),D
+	dec  HL
+	ld   (HL),E
+
+	pop  AF
+	ret  PO					//the interrupts were disabled
+	ei
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+VQ_GetFreq
+Description: 
+		Reads the MSXID1 byte from the main BIOS-ROM.
+		Bit 7: default interrupt frequency (0 = 60Hz, 1 = 50Hz)
+Input:	-
+Output:	[char] MSXID1 value
+============================================================================= */
+char VQ_GetFreq(void) __naked
+{
+__asm
+	ld   HL,#MSXID1
+	ld   A,(#EXPTBL)		//EXPTBL=main BIOS-ROM slot address
+	call 0x000C				//RDSLT Reads the value of an address in another slot
+	ei
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+DrainVQueue
+Description: 
+		Executes the commands of the queue and then advances the running 
+		transfers, with the unpaced VRAM access, until there is nothing left 
+		to do or the byte budget is used up.
+		Only call it in the vertical retrace (or with the display disabled).
+		The VRAM functions that it uses enable the interrupts (EI). If the 
+		drain does not end before the next interrupt and this one calls 
+		DrainVQueue again (hook, VDP_ISR), the second call returns at once 
+		and the first one continues.
+Input:	-
+Output:	-
+============================================================================= */
+void DrainVQueue(void) __naked
+{
+__asm
+	ld   HL,#_VQ_busy
+	ld   A,(HL)
+	or   A
+	ret  NZ					//the interrupt has stopped a DrainVQueue in the middle of an entry
+	inc  (HL)
+
+	push IX
+
+	ld   HL,(#_VQ_budget)
+	ld   (#_VQ_left),HL
+
+VQ_loop$:
+	ld   A,(#_VQ_head)
+	ld   B,A
+	ld   A,(#_VQ_tail)
+	cp   B
+	jr   Z,VQ_transfer$		//empty queue
+
+	ld   L,B
+	ld   H,#0
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL				//head x 8
+	ld   DE,#_VQ_buffer
+	add  HL,DE
+	push HL
+	pop  IX					//IX = entry
+
+	call VQ_cost$
+	jr   C,VQ_END$			//budget used up
+
+	ld   A,0(IX)
+	cp   #VQ_POKE
+	jr   NC,VQ_single$		//VQ_POKE or VQ_REG
+
+	ld   E,4(IX)
+	ld   D,5(IX)			//DE = size
+	or   A
+	sbc  HL,DE				//left - size
+	jr   C,VQ_partial$
+
+	ld   (#_VQ_left),HL
+	call VQ_exec$			//the whole block
+	jr   VQ_next$
+
+VQ_partial$:
+	ld   DE,(#_VQ_left)		//only the bytes left in this frame
+	ld   HL,#0
+	ld   (#_VQ_left),HL
+	call VQ_exec$			//the entry is updated for the next frame
+	jr   VQ_END$
+
+VQ_single$:
+	ld   A,0(IX)
+	cp   #VQ_REG
+	jr   Z,VQ_reg$
+
+	ld   L,2(IX)
+	ld   H,3(IX)
+	ld   A,1(IX)
+	call WriteByteToVRAM	//HL<--VRAM address; A<--value
+	jr   VQ_next$
+
+VQ_reg$:
+	ld   C,2(IX)			//register number
+	ld   A,1(IX)			//value
+	call writeVDP
+
+VQ_next$:
+	ld   A,(#_VQ_head)
+	inc  A
+	and  #VQUEUE_SIZE-1
+	ld   (#_VQ_head),A
+	jr   VQ_loop$
+
+//running transfers
+VQ_transfer$:
+	ld   HL,(#_VQ_transfers)
+	ld   A,H
+	or   L
+	jr   Z,VQ_END$			//no transfers
+	push HL
+	pop  IX					//IX = transfer
+
+	call VQ_cost$
+	jr   C,VQ_END$			//budget used up
+
+	ld   E,4(IX)
+	ld   D,5(IX)			//DE = bytes left
+	or   A
+	sbc  HL,DE
+	jr   C,VQ_partial$
+
+	ld   (#_VQ_left),HL
+	call VQ_exec$			//the rest of the transfer
+
+	ld   L,8(IX)
+	ld   H,9(IX)
+	ld   (#_VQ_transfers),HL	//next transfer
+	jr   VQ_transfer$
+
+VQ_END$:
+	pop  IX
+	xor  A
+	ld   (#_VQ_busy),A
+	ret
+
+
+
+/* -----------------------------------------------------------------------------
+VQ_cost$
+Takes the cost of a command (VQUEUE_CMDCOST) from the budget.
+Output:	HL - bytes left
+		Carry - budget used up
+----------------------------------------------------------------------------- */
+VQ_cost$:
+	ld   HL,(#_VQ_left)
+	ld   DE,#VQUEUE_CMDCOST
+	or   A
+	sbc  HL,DE
+	ret  C
+	ld   (#_VQ_left),HL
+	ret
+
+
+
+/* -----------------------------------------------------------------------------
+VQ_exec$
+Executes a copy or fill of DE bytes and advances the entry.
+Input:	IX - entry
+		DE - number of bytes
+----------------------------------------------------------------------------- */
+VQ_exec$:
+	push DE
+	ld   L,2(IX)
+	ld   H,3(IX)			//HL = VRAM address
+
+	ld   A,0(IX)
+	cp   #VQ_FILL
+	jr   Z,VQ_fill$
+
+	ld   B,D
+	ld   C,E				//BC = size
+	ld   E,6(IX)
+	ld   D,7(IX)			//DE = Memory address
+	call fastLDIR2VRAM
+	jr   VQ_update$
+
+VQ_fill$:
+	ld   A,1(IX)
+	call fastFillVR			//HL<--VRAM address; DE<--size; A<--value
+
+VQ_update$:
+	pop  DE
+
+	ld   L,2(IX)
+	ld   H,3(IX)
+	add  HL,DE
+	ld   2(IX),L
+	ld   3(IX),H			//VRAM address + n
+
+	ld   L,6(IX)
+	ld   H,7(IX)
+	add  HL,DE
+	ld   6(IX),L
+	ld   7(IX),H			//Memory address + n
+
+	ld   L,4(IX)
+	ld   H,5(IX)
+	or   A
+	sbc  HL,DE
+	ld   4(IX),L
+	ld   5(IX),H			//size - n
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+EnableVQueueHook
+Description: 
+		Installs DrainVQueue in the hook of the VDP interrupt (H.TIMI).
+		The previous hook is called after draining the queue.
+		While the hook is enabled, the interrupt changes the VRAM address: 
+		the functions that access the VRAM must be called between 
+		PauseVQueue and ResumeVQueue.
+		Keeps the interrupt state of the caller.
+Input:	-
+Output:	-
+============================================================================= */
+void EnableVQueueHook(void) __naked
+{
+__asm
+	ld   A,I				//P/V = IFF2
+	jp   PE,VQ_ENABLEiff$
+	ld   A,I				//NMOS Z80: P/V=0 if an interrupt was accepted in the first LD A,I
+VQ_ENABLEiff$:
+	push AF
+	di
+	ld   HL,#H_TIMI
+	ld   DE,#_VQ_oldhook
+	ld   BC,#5
+	ldir					//save the previous hook
+
+	ld   A,#0xC3			//JP
+	ld   (#H_TIMI),A
+	ld   HL,#VQ_hook$
+	ld   (#H_TIMI+1),HL
+
+	pop  AF
+	ret  PO					//the interrupts were disabled
+	ei
+	ret
+
+VQ_hook$:
+	push AF					//A = S#0
+	ld   A,(#_VQ_paused)
+	or   A
+	call Z,_DrainVQueue
+	pop  AF
+	jp   _VQ_oldhook
+__endasm;
+}
+
+
+
+/* =============================================================================
+DisableVQueueHook
+Description: 
+		Restores the previous H.TIMI hook.
+		Keeps the interrupt state of the caller.
+Input:	-
+Output:	-
+============================================================================= */
+void DisableVQueueHook(void) __naked
+{
+__asm
+	ld   A,I				//P/V = IFF2
+	jp   PE,VQ_DISABLEiff$
+	ld   A,I				//NMOS Z80: P/V=0 if an interrupt was accepted in the first LD A,I
+VQ_DISABLEiff$:
+	push AF
+	di
+	ld   HL,#_VQ_oldhook
+	ld   DE,#H_TIMI
+	ld   BC,#5
+	ldir
+
+	pop  AF
+	ret  PO					//the interrupts were disabled
+	ei
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+PauseVQueue
+Description: 
+		The hook stops executing the queue (the commands are kept), so the 
+		program can use the functions that access the VRAM (CopyToVRAM, 
+		VPOKE, PUTSPRITE, FlushOAM...).
+		The functions that only write registers (SetVDP, COLOR...) or RAM 
+		buffers can be used without pausing it.
+Input:	-
+Output:	-
+============================================================================= */
+void PauseVQueue(void)
+{
+	VQ_paused = 1;
+}
+
+
+
+/* =============================================================================
+ResumeVQueue
+Description: 
+		The hook executes the queue again from the next interrupt.
+Input:	-
+Output:	-
+============================================================================= */
+void ResumeVQueue(void)
+{
+	VQ_paused = 0;
+}
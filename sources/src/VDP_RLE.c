@@ -0,0 +1,84 @@
+/* ==============================================================================                                                                            
+# VDP_RLE MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+RLE decompression directly to VRAM, without a buffer in RAM.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_RLE.h"
+
+
+
+/* =============================================================================
+RLEtoVRAM
+Description: 
+		Decompresses RLE data directly to VRAM.
+		The runs are written with the fillVR loop and the literals with 
+		the LDIR2VRAM loop (unpaced when the display is disabled).
+Input:	[unsigned int] compressed data Memory address
+		[unsigned int] VRAM address
+Output:	[unsigned int] next VRAM address after the decompressed data
+============================================================================= */
+unsigned int RLEtoVRAM(unsigned int addr, unsigned int vaddr) __naked
+{
+addr;	//HL
+vaddr;	//DE
+__asm
+	ex   DE,HL				//DE = data; HL = VRAM address
+
+RLE_loop$:
+	ld   A,(DE)
+	inc  DE
+	or   A
+	jr   Z,RLE_end$			//0x00 = end
+	jp   M,RLE_run$
+
+//literals: A = length (1-127)
+	ld   C,A
+	ld   B,#0
+	push HL
+	add  HL,BC
+	ex   (SP),HL			//(SP) = next VRAM address
+	call LDIR2VRAM			//returns HL = next data
+	ex   DE,HL
+	pop  HL
+	jr   RLE_loop$
+
+//run: length = (A AND 0x7F)+1 (1-128)
+RLE_run$:
+	and  #0x7F
+	inc  A
+	ld   C,A
+	ld   A,(DE)				//value
+	inc  DE
+	push DE
+	ld   E,C
+	ld   D,#0				//DE = length
+	push HL
+	add  HL,DE
+	ex   (SP),HL			//(SP) = next VRAM address
+	call fillVR
+	pop  HL
+	pop  DE
+	jr   RLE_loop$
+
+RLE_end$:
+	ex   DE,HL				//DE = next VRAM address
+	ret
+__endasm;
+}
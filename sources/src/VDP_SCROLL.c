@@ -0,0 +1,350 @@
+/* ==============================================================================                                                                            
+# VDP_SCROLL MSX Library (fR3eL Project)
+
+- Version: 1.1 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Tile scroll (8 pixels) of a map for Graphic1 and Graphic2 modes.
+The visible window (32x24) is kept in a RAM buffer used as a ring in both 
+directions: each step only reads the new column or row from the map, and 
+FlushScroll sends the window, in order, with a single VRAM address setup.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.1 (17/10/2026) FlushScroll: the rows after the first one were shifted when 
+  the left column of the window was not the first of the ring.
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_SCROLL.h"
+
+
+
+char SCROLL_window[SCROLL_ROWS * SCROLL_COLUMNS];
+char SCROLL_cx;		//ring column of the left column of the window
+char SCROLL_cy;		//ring row of the top row of the window
+
+unsigned int SCROLL_x;
+unsigned int SCROLL_y;
+unsigned int SCROLL_width;
+unsigned int SCROLL_height;
+const char* SCROLL_origin;	//tile of the map at the upper left corner
+unsigned int SCROLL_bottom;	//offset of the last row of the window (23 * width)
+
+
+
+void SCROLL_FillColumn(char column, const char* src);
+void SCROLL_FillRow(char row, const char* src);
+
+
+
+/* =============================================================================
+InitScroll
+Description: 
+		Initializes the scroll with a map and the position of the window, 
+		and loads the visible window in the RAM buffer.
+		Call FlushScroll to show it.
+Input:	[const SCROLL_MAP*] map
+		[unsigned int] column of the window
+		[unsigned int] row of the window
+Output:	-
+============================================================================= */
+void InitScroll(const SCROLL_MAP* world, unsigned int x, unsigned int y)
+{
+	char row;
+	const char* src;
+	
+	SCROLL_width = world->width;
+	SCROLL_height = world->height;
+	SCROLL_x = x;
+	SCROLL_y = y;
+	SCROLL_cx = 0;
+	SCROLL_cy = 0;
+	SCROLL_origin = world->map + y * SCROLL_width + x;
+	SCROLL_bottom = (SCROLL_ROWS - 1) * SCROLL_width;
+	
+	src = SCROLL_origin;
+	for (row = 0; row < SCROLL_ROWS; row++)
+	{
+		SCROLL_FillRow(row, src);
+		src += SCROLL_width;
+	}
+}
+
+
+
+/* =============================================================================
+ScrollRight
+Description: 
+		Moves the window one tile to the right (the map scrolls to the left).
+		Only the new column is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollRight(void)
+{
+	if (SCROLL_x + SCROLL_COLUMNS >= SCROLL_width) return 0;
+	
+	SCROLL_x++;
+	SCROLL_origin++;
+	SCROLL_FillColumn(SCROLL_cx, SCROLL_origin + (SCROLL_COLUMNS - 1));	//the left column becomes the right one
+	SCROLL_cx = (SCROLL_cx + 1) & (SCROLL_COLUMNS - 1);
+	return 1;
+}
+
+
+
+/* =============================================================================
+ScrollLeft
+Description: 
+		Moves the window one tile to the left.
+		Only the new column is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollLeft(void)
+{
+	if (SCROLL_x == 0) return 0;
+	
+	SCROLL_x--;
+	SCROLL_origin--;
+	SCROLL_cx = (SCROLL_cx - 1) & (SCROLL_COLUMNS - 1);
+	SCROLL_FillColumn(SCROLL_cx, SCROLL_origin);
+	return 1;
+}
+
+
+
+/* =============================================================================
+ScrollDown
+Description: 
+		Moves the window one tile down.
+		Only the new row is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollDown(void)
+{
+	if (SCROLL_y + SCROLL_ROWS >= SCROLL_height) return 0;
+	
+	SCROLL_y++;
+	SCROLL_origin += SCROLL_width;
+	SCROLL_FillRow(SCROLL_cy, SCROLL_origin + SCROLL_bottom);	//the top row becomes the bottom one
+	if (++SCROLL_cy == SCROLL_ROWS) SCROLL_cy = 0;
+	return 1;
+}
+
+
+
+/* =============================================================================
+ScrollUp
+Description: 
+		Moves the window one tile up.
+		Only the new row is read from the map.
+Input:	-
+Output:	[char] 1 = moved; 0 = end of the map
+============================================================================= */
+char ScrollUp(void)
+{
+	if (SCROLL_y == 0) return 0;
+	
+	SCROLL_y--;
+	SCROLL_origin -= SCROLL_width;
+	if (SCROLL_cy == 0) SCROLL_cy = SCROLL_ROWS;
+	SCROLL_cy--;
+	SCROLL_FillRow(SCROLL_cy, SCROLL_origin);
+	return 1;
+}
+
+
+
+/* =============================================================================
+FlushScroll
+Description: 
+		Sends the window to the name table (VDP_Layout.map) with a single 
+		VRAM address setup. 
+		Takes about 26400 T-states: use it with SetBackMap/FlipMap to avoid 
+		tearing.
+Input:	-
+Output:	-
+============================================================================= */
+void FlushScroll(void) __naked
+{
+__asm
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout)	//Name Table
+	call _SetVDPtoWRITE
+
+	ld   A,(#_SCROLL_cy)
+	call SCROLL_GetRow$		//HL = top row of the window
+	ld   C,#VDPVRAM
+
+	ld   A,(#_SCROLL_cy)
+	neg
+	add  A,#SCROLL_ROWS		//rows up to the end of the ring
+	call SCROLL_OutRows$
+
+	ld   A,(#_SCROLL_cy)
+	or   A
+	ret  Z
+	ld   HL,#_SCROLL_window	//rest of the rows, from the start of the ring
+
+//Input: A - rows; HL - row address; C - VDPVRAM
+SCROLL_OutRows$:
+	push AF
+	push HL
+	ld   A,(#_SCROLL_cx)
+	ld   E,A
+	ld   D,#0
+	add  HL,DE				//from the left column of the window
+	ld   A,#SCROLL_COLUMNS
+	sub  E
+	ld   B,A
+SCROLL_OUT1$:
+	outi					//(18ts)
+	jp   NZ,SCROLL_OUT1$	//(11ts)
+
+	pop  HL					//the columns before it, from the start of the row
+	ld   A,E
+	or   A
+	jr   Z,SCROLL_OUTnext$
+	push HL
+	ld   B,A
+SCROLL_OUT2$:
+	outi
+	jp   NZ,SCROLL_OUT2$
+	pop  HL					//start of the row
+
+SCROLL_OUTnext$:
+	ld   DE,#SCROLL_COLUMNS
+	add  HL,DE
+	pop  AF
+	dec  A
+	jr   NZ,SCROLL_OutRows$
+	ret
+
+
+//Input: A - ring row; Output: HL - address in SCROLL_window
+SCROLL_GetRow$:
+	ld   L,A
+	ld   H,#0
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL
+	add  HL,HL				//x32
+	ld   DE,#_SCROLL_window
+	add  HL,DE
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+SCROLL_FillColumn
+Description: 
+		Copies a column of the map to a column of the ring, starting at 
+		the top row of the window.
+Input:	[char] ring column
+		[const char*] first tile of the column in the map
+Output:	-
+============================================================================= */
+void SCROLL_FillColumn(char column, const char* src) __naked
+{
+column;	//A
+src;	//DE
+__asm
+	push DE
+	ld   E,A
+	ld   D,#0
+	ld   A,(#_SCROLL_cy)
+	call SCROLL_GetRow$
+	add  HL,DE
+	ex   DE,HL				//DE = target
+	pop  HL					//HL = source
+	ld   BC,(#_SCROLL_width)
+
+	ld   A,(#_SCROLL_cy)
+	neg
+	add  A,#SCROLL_ROWS		//rows up to the end of the ring
+	call SCROLL_Column$
+
+	ld   A,(#_SCROLL_cy)
+	or   A
+	ret  Z
+	push HL
+	ld   HL,#-(SCROLL_ROWS * SCROLL_COLUMNS)
+	add  HL,DE
+	ex   DE,HL				//back to the first row of the ring
+	pop  HL
+
+//Input: A - rows; HL - source; DE - target; BC - map width
+SCROLL_Column$:
+	ex   AF,AF
+	ld   A,(HL)				//( 8ts)
+	ld   (DE),A				//( 8ts)
+	add  HL,BC				//(12ts) next row of the map
+	ld   A,E				//( 5ts)
+	add  A,#SCROLL_COLUMNS	//( 8ts) next row of the ring
+	ld   E,A				//( 5ts)
+	jr   NC,SCROLL_Column1$	//(13ts)
+	inc  D
+SCROLL_Column1$:
+	ex   AF,AF
+	dec  A
+	jr   NZ,SCROLL_Column$
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+SCROLL_FillRow
+Description: 
+		Copies a row of the map to a row of the ring, starting at the left 
+		column of the window.
+Input:	[char] ring row
+		[const char*] first tile of the row in the map
+Output:	-
+============================================================================= */
+void SCROLL_FillRow(char row, const char* src) __naked
+{
+row;	//A
+src;	//DE
+__asm
+	push DE					//source
+	call SCROLL_GetRow$
+	push HL					//row address
+	ld   A,(#_SCROLL_cx)
+	ld   E,A
+	ld   D,#0
+	add  HL,DE
+	ex   DE,HL				//DE = row + left column; L = left column
+	ld   A,#SCROLL_COLUMNS
+	sub  L
+	ld   C,A
+	ld   B,#0
+	pop  HL
+	ex   (SP),HL			//HL = source; (SP) = row address
+	ldir					//from the left column to the end of the row
+
+	pop  DE
+	ld   A,(#_SCROLL_cx)
+	or   A
+	ret  Z
+	ld   C,A
+	ldir					//the rest, from the start of the row
+	ret
+__endasm;
+}
@@ -0,0 +1,248 @@
+/* ==============================================================================                                                                            
+# VDP_SPRMUX MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Sprite multiplexer to work around the limit of four sprites per line of the 
+TMS9918A.
+The logical list (up to SPRMUX_MAX sprites) is sorted by Y and written to the 
+Sprite Attribute Table with a rotating priority, so the sprites that the VDP 
+does not show in one frame are shown in the next one.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_SPRMUX.h"
+
+
+
+char SPRMUX_count;		//number of sprites in the logical list
+char SPRMUX_lastcount;	//number of sprites in the previous frame
+char SPRMUX_offset;		//logical position assigned to plane 0
+
+char SPRMUX_order[SPRMUX_MAX];	//logical list sorted by Y
+char SPRMUX_attr[SPRMUX_MAX*4];	//Y, X, pattern, color
+
+
+
+void SPRMUX_WriteOAM(void);
+
+
+
+/* =============================================================================
+InitSpriteMUX
+Description: 
+		Initializes the sprite multiplexer.
+		Empties the logical list and resets the priority rotation.
+Input:	-
+Output:	-
+============================================================================= */
+void InitSpriteMUX(void)
+{
+	SPRMUX_count = 0;
+	SPRMUX_lastcount = 0;
+	SPRMUX_offset = 0;
+}
+
+
+
+/* =============================================================================
+ClearSpriteMUX
+Description: 
+		Empties the logical sprite list. 
+		Call it at the beginning of each frame, before adding the sprites.
+Input:	-
+Output:	-
+============================================================================= */
+void ClearSpriteMUX(void)
+{
+	SPRMUX_count = 0;
+}
+
+
+
+/* =============================================================================
+AddSpriteMUX
+Description: 
+		Adds a sprite to the logical list.
+		Y=208 is the end of table mark of the VDP, do not use it.
+Input:	[char] X coordinate 
+		[char] Y coordinate
+		[char] color (0-15)
+		[char] pattern number
+Output:	[char] index in the logical list or SPRMUX_FULL
+============================================================================= */
+char AddSpriteMUX(char x, char y, char color, char pattern)
+{
+	char* attr;
+	char index = SPRMUX_count;
+	
+	if (index >= SPRMUX_MAX) return SPRMUX_FULL;
+	
+	//if spritesize = 16x16 then pattern*4
+	if (*(char*) RG1SAV & 0b00000010) pattern <<= 2;
+	
+	attr = &SPRMUX_attr[index << 2];
+	*attr++ = y;
+	*attr++ = x;
+	*attr++ = pattern;
+	*attr = color;
+	
+	SPRMUX_count++;
+	return index;
+}
+
+
+
+/* =============================================================================
+UpdateSpriteMUX
+Description: 
+		Sorts the logical list by Y, rotates the priorities and writes the 
+		result to the Sprite Attribute Table (VDP_Layout.oam) in one pass.
+		The rotation uses the 5th sprite flag and number of the status 
+		register S#0 stored in STATFL by the interrupt routine. If there are 
+		no more than four sprites per line, the order is kept (no flicker).
+Input:	-
+Output:	-
+============================================================================= */
+void UpdateSpriteMUX(void)
+{
+	unsigned char i, j, index, key;
+	unsigned char n = SPRMUX_count;
+	unsigned char status = *(char*) STATFL;	//S#0 read by the interrupt routine
+	
+	// The list changes size: start again from the order of insertion.
+	// Otherwise the previous order is almost sorted and the insertion sort 
+	// only needs a few moves.
+	// The rotation is kept: it is only wrapped to the new size below.
+	if (n != SPRMUX_lastcount)
+	{
+		for (i = 0; i < n; i++) SPRMUX_order[i] = i;
+		SPRMUX_lastcount = n;
+	}
+	
+	// Insertion sort by Y. 
+	// Adds 32 so that the lines above the screen (Y=224 to 255) come first.
+	for (i = 1; i < n; i++)
+	{
+		index = SPRMUX_order[i];
+		key = SPRMUX_attr[index << 2] + 32;
+		j = i;
+		while (j > 0 && (unsigned char)(SPRMUX_attr[SPRMUX_order[j - 1] << 2] + 32) > key)
+		{
+			SPRMUX_order[j] = SPRMUX_order[j - 1];
+			j--;
+		}
+		SPRMUX_order[j] = index;
+	}
+	
+	// Priority rotation
+	if (n > 0)
+	{
+		if (status & 0b01000000)		//5S flag: the 5th sprite gets plane 0
+			SPRMUX_offset += status & 0b00011111;
+		else if (n > 32)				//more sprites than planes
+			SPRMUX_offset += 32;
+		
+		while (SPRMUX_offset >= n) SPRMUX_offset -= n;
+	}
+	
+	SPRMUX_WriteOAM();
+}
+
+
+
+/* =============================================================================
+SPRMUX_WriteOAM
+Description: 
+		Writes the logical list to the Sprite Attribute Table, starting with 
+		the SPRMUX_offset position. 
+		If there are less than 32 sprites, it ends the table with Y=208.
+Input:	-
+Output:	-
+============================================================================= */
+void SPRMUX_WriteOAM(void) __naked
+{
+__asm
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout+6)	//Sprite Attribute Table
+	call _SetVDPtoWRITE
+
+	ld   A,(#_SPRMUX_count)
+	or   A
+	jr   Z,SPRMUX_END$
+
+	ld   B,A				//B = logical sprites
+	cp   #33
+	jr   C,SPRMUX_planes$
+	ld   A,#32				//32 planes max
+SPRMUX_planes$:
+	ld   C,A				//C = planes to write
+
+	ld   A,(#_SPRMUX_offset)
+	ld   E,A				//E = position in the sorted list
+	ld   D,#0
+
+SPRMUX_loop$:
+	push BC
+
+	ld   HL,#_SPRMUX_order
+	add  HL,DE
+	ld   A,(HL)
+	add  A
+	add  A				//multiply x 4
+	ld   L,A
+	ld   H,#0
+	ld   BC,#_SPRMUX_attr
+	add  HL,BC
+
+	ld   A,(HL)				//( 8ts)
+	out  (VDPVRAM),A		//(12ts) Y
+	inc  HL					//( 7ts)
+	ld   A,(HL)				//( 8ts)
+	nop						//( 5ts) 12+7+8+5 = 32ts
+	out  (VDPVRAM),A		//X
+	inc  HL
+	ld   A,(HL)
+	nop
+	out  (VDPVRAM),A		//pattern
+	inc  HL
+	ld   A,(HL)
+	nop
+	out  (VDPVRAM),A		//color
+
+	pop  BC
+
+	inc  E					//next position in the sorted list
+	ld   A,E
+	cp   B
+	jr   NZ,SPRMUX_next$
+	ld   E,#0				//rotation
+SPRMUX_next$:
+	dec  C
+	jr   NZ,SPRMUX_loop$
+
+	ld   A,(#_SPRMUX_count)
+	cp   #32
+	ret  NC					//all planes used
+
+SPRMUX_END$:
+	ld   A,#0xD0			//Y=208 end of Sprite Attribute Table
+	out  (VDPVRAM),A
+	ret
+__endasm;
+}
@@ -1,7 +1,7 @@
 /* ==============================================================================                                                                            
 # VDP_TMS9918A MSX Library (fR3eL Project)
 
-- Version: 1.7.1 (27/07/2025)
+- Version: 1.8 (17/10/2026)
 - Author: mvac7/303bcn
 - Architecture: MSX
 - Environment: ROM, MSX-DOS or BASIC
@@ -22,6 +22,28 @@ Features:
  
 ## History of versions (dd/mm/yyyy):
 
+- v1.8 (17/10/2026)
+	- FillVRAM, CopyToVRAM and CopyFromVRAM use an unpaced unrolled loop 
+	  when the display is disabled (BLK=0). 
+	  Added fastFillVR, fastLDIR2VRAM and fastGetBLOCKfromVRAM inline labels.
+	  A size of 0 transfers nothing in both loops.
+	- Fix ClearSprites: the time between the Y and X writes was 27 T-states.
+	- Fix VPEEK: the value was read 28 T-states after the address setup.
+	- Added GetVRAMlayout. Without SCREEN, or when registers 2 to 6 are 
+	  changed by other means, VDP_Layout is loaded from the VDP registers 
+	  (RG2SAV to RG6SAV) the first time it is needed.
+	- The switch of the instrumented build is VDP_STATS_BUILD (VDP_STATS is 
+	  the type of the statistics).
+	- VPOKE, FillVRAM, CopyToVRAM, CopyFromVRAM, COLOR and PUTSPRITE read the 
+	  stack parameters without the IX frame.
+	- Added WriteVRAMbyte, FillVRAMblock, CopyToVRAMblock, CopyFromVRAMblock 
+	  and PutSpriteAttr functions, with the parameters in registers.
+	- Added ExecVRAMlist and CopyToVRAM_G2x3 functions.
+	- SCREEN: added the GRAPHIC2_MASKED mode.
+	- Added VDP_Layout, SetVRAMlayout, SetBackMap and FlipMap.
+	- Added InitFrameSync, WaitVBlank, GetFrameCount and GetDroppedFrames.
+	  WaitVBlank reads the interrupt state twice (LD A,I of the NMOS Z80).
+	- Added the instrumented build (-DVDP_STATS_BUILD), GetVDPstats and ResetVDPstats.
 - v1.7.1 (27/07/2025)
 	- Fix Bug #17 Error assigning colors in Text1 mode
 - v1.7 (17/07/2025) 
@@ -58,6 +80,23 @@ Features:
 
 
 
+VRAM_LAYOUT VDP_Layout;	//active VRAM tables (offsets: map 0, col 2, pat 4, oam 6, spr 8)
+char TMS_layoutRG[5];	//R#2 to R#6 of VDP_Layout (TMS_CheckLayout)
+
+#ifdef VDP_STATS_BUILD
+VDP_STATS VDP_Stats;	//instrumented build
+
+// offsets in VDP_STATS
+#define STATS_SETUPS	0
+#define STATS_REGISTERS	2
+#define STATS_WRITTEN	4
+#define STATS_READ		8
+#define STATS_CALLS		12
+#define STATS_SIZE		(STATS_CALLS + VDPSTAT_FUNCTIONS * 2)
+#endif
+
+
+
 
 
 
@@ -76,12 +115,19 @@ Input:	[char] number of screen mode
 			1 = Graphic1
 			2 = Graphic2
 			3 = MultiColor
+			4 = Graphic2 with one bank (GRAPHIC2_MASKED). The three thirds 
+			    of the screen use the patterns of G2_PAT_A and the colors of 
+			    G2_COL_A (R#3 = 0x9F; R#4 = 0x00).
 Output:	-
 ============================================================================= */
 void SCREEN(char mode) __naked
 {
 mode;	//A
 __asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SCREEN
+#endif
 	push IX
 
 	cp   #0
@@ -90,15 +136,32 @@ __asm
 	jr   Z,TMS_screen1$
 	cp   #3
 	jr   Z,TMS_screen3$
+	cp   #GRAPHIC2_MASKED
+	jr   Z,TMS_screen2m$
 
 //TMS_screen2$:
+	ld   HL,#layout_GFX2
+	ld   DE,#mode_GFX2+2
+	call TMS_SetLayout$
 	call ClearG1G2
-	call _ClearSprites      
+	call TMS_ClearSprites$      
 	ld   HL,#mode_GFX2
 	jr   TMS_setREGs$
 
+TMS_screen2m$:
+	ld   HL,#layout_GFX2
+	ld   DE,#mode_GFX2M+2
+	call TMS_SetLayout$
+	call ClearG1G2
+	call TMS_ClearSprites$      
+	ld   HL,#mode_GFX2M
+	jr   TMS_setREGs$
+
   
 TMS_screen0$:
+	ld   HL,#layout_TXT1
+	ld   DE,#mode_TXT1+2
+	call TMS_SetLayout$
     call TMS_colorMode0$
 	call ClearT1
 
@@ -109,15 +172,21 @@ TMS_screen0$:
 	jr   TMS_setREGs$
 
 TMS_screen1$:
+	ld   HL,#layout_GFX1
+	ld   DE,#mode_GFX1+2
+	call TMS_SetLayout$
 	call TMS_initG1$
 	call ClearG1G2
-	call _ClearSprites    
+	call TMS_ClearSprites$    
 	ld   HL,#mode_GFX1
 	jr   TMS_setREGs$
 	
 TMS_screen3$:
+	ld   HL,#layout_MC
+	ld   DE,#mode_MC+2
+	call TMS_SetLayout$
 	call ClearMC
-	call _ClearSprites  
+	call TMS_ClearSprites$  
 	ld   HL,#mode_MC
 
 TMS_setREGs$:
@@ -152,6 +221,166 @@ TMS_screenEND$:
 
 
 
+/* --------------------------------------------------------------------------
+Copies the default layout of the mode to VDP_Layout
+Input:	HL - pointer to the layout
+		DE - values of R#2 to R#6 of the layout
+Regs:	A, BC, DE, HL
+-------------------------------------------------------------------------- */
+TMS_SetLayout$:
+	push DE
+	ld   DE,#_VDP_Layout
+	ld   BC,#10
+	ldir
+	pop  HL
+
+//Input: HL - values of R#2 to R#6
+TMS_SetLayoutRG$:
+	ld   DE,#_TMS_layoutRG
+	ld   BC,#5
+	ldir
+	ret
+
+
+
+/* --------------------------------------------------------------------------
+TMS_CheckLayout
+Checks that VDP_Layout belongs to the registers 2 to 6 saved in the system 
+variables (RG2SAV to RG6SAV), and loads it from them if not: the program 
+keeps the screen mode of BASIC or MSX-DOS and does not call SCREEN or 
+SetVRAMlayout, or the registers have been changed with SetVDP or the BIOS.
+Does not depend on the value of the RAM at startup.
+Regs:	A
+-------------------------------------------------------------------------- */
+TMS_CheckLayout::
+	push HL
+	ld   HL,#_TMS_layoutRG
+	ld   A,(#RG0SAV+2)
+	cp   (HL)
+	jr   NZ,TMS_CHECKload$
+	inc  HL
+	ld   A,(#RG0SAV+3)
+	cp   (HL)
+	jr   NZ,TMS_CHECKload$
+	inc  HL
+	ld   A,(#RG0SAV+4)
+	cp   (HL)
+	jr   NZ,TMS_CHECKload$
+	inc  HL
+	ld   A,(#RG0SAV+5)
+	cp   (HL)
+	jr   NZ,TMS_CHECKload$
+	inc  HL
+	ld   A,(#RG0SAV+6)
+	cp   (HL)
+	jr   NZ,TMS_CHECKload$
+	pop  HL
+	ret
+
+TMS_CHECKload$:
+	pop  HL					//continues in TMS_LoadLayout
+
+
+
+/* --------------------------------------------------------------------------
+TMS_LoadLayout
+Loads VDP_Layout from the registers 2 to 6 saved in the system variables 
+(RG2SAV to RG6SAV) and keeps a copy of them in TMS_layoutRG.
+Regs:	A
+-------------------------------------------------------------------------- */
+TMS_LoadLayout::
+	push HL
+	push DE
+	push BC
+	ld   HL,#_VDP_Layout
+	ld   A,(#RG0SAV)
+	and  #0x02
+	ld   C,A				//C = M3 (Graphic2)
+
+//map = R#2 x 0x400
+	ld   A,(#RG0SAV+2)
+	and  #0x0F
+	add  A,A
+	add  A,A
+	ld   (HL),#0
+	inc  HL
+	ld   (HL),A
+	inc  HL
+
+//col = R#3 x 0x40 (Graphic2: bit 7 --> 0x0000 or 0x2000)
+	ld   A,(#RG0SAV+3)
+	ld   E,A
+	inc  C
+	dec  C
+	jr   Z,TMS_LOADcol$
+	and  #0x80
+	rrca
+	rrca					//0x80 --> 0x20
+	ld   (HL),#0
+	inc  HL
+	ld   (HL),A
+	jr   TMS_LOADpat$
+TMS_LOADcol$:
+	rrca
+	rrca
+	and  #0xC0
+	ld   (HL),A
+	inc  HL
+	ld   A,E
+	srl  A
+	srl  A
+	ld   (HL),A
+
+//pat = R#4 x 0x800 (Graphic2: bit 2 --> 0x0000 or 0x2000)
+TMS_LOADpat$:
+	inc  HL
+	ld   A,(#RG0SAV+4)
+	and  #0x07
+	inc  C
+	dec  C
+	jr   Z,TMS_LOADpat2$
+	and  #0x04
+TMS_LOADpat2$:
+	add  A,A
+	add  A,A
+	add  A,A
+	ld   (HL),#0
+	inc  HL
+	ld   (HL),A
+	inc  HL
+
+//oam = R#5 x 0x80
+	ld   A,(#RG0SAV+5)
+	and  #0x7F
+	ld   E,A
+	rrca
+	and  #0x80
+	ld   (HL),A
+	inc  HL
+	ld   A,E
+	srl  A
+	ld   (HL),A
+	inc  HL
+
+//spr = R#6 x 0x800
+	ld   A,(#RG0SAV+6)
+	and  #0x07
+	add  A,A
+	add  A,A
+	add  A,A
+	ld   (HL),#0
+	inc  HL
+	ld   (HL),A
+
+	ld   HL,#RG0SAV+2
+	call TMS_SetLayoutRG$
+	pop  BC
+	pop  DE
+	pop  HL
+	ret
+
+
+
 /* --------------------------------------------------------------------------
 -------------------------------------------------------------------------- */
 TMS_SetCOLORs:
@@ -210,7 +439,7 @@ TMS_initG1$:
 	or   B
 	
 	ld   DE,#32
-	ld   HL,#G1_COL
+	ld   HL,(#_VDP_Layout+2)	//Color Table
 	jp   fillVR			;fill color table with Ink+BG Colors
 // --------------------------------------------------------------
 
@@ -255,6 +484,17 @@ mode_GFX2:
  .db 0x36		//reg5 Sprite Attribute Table	(1B00h)
  .db 0x07		//reg6 Sprite Pattern Table		(3800h)
 
+//Graphic2 with one bank> M1=0; M2=0; M3=1
+//The address bits of the third are masked: all thirds use bank A
+mode_GFX2M:
+ .db 0B00000010 //reg0
+ .db 0B11100000 //reg1 Default sprites 8x8 No Zoom
+ .db 0x06		//reg2 Name Table				(1800h)
+ .db 0x9F		//reg3 Color Table				(2000h) 2K
+ .db 0x00		//reg4 Pattern Table			(0000h) 2K
+ .db 0x36		//reg5 Sprite Attribute Table	(1B00h)
+ .db 0x07		//reg6 Sprite Pattern Table		(3800h)
+
 //MultiColor> M1=0; M2=1; M3=0
 mode_MC:
  .db 0B00000000	//reg0 $00
@@ -265,12 +505,100 @@ mode_MC:
  .db 0x36		//reg5 Sprite Attribute Table	(1B00h)
  .db 0x07		//reg6 Sprite Pattern Table		(3800h)  
 // --------------------------------------------------------------
+
+
+
+/* ----------------------------------------------------------
+Default layouts (VRAM_LAYOUT), same as the register values
+map, col, pat, oam, spr
+---------------------------------------------------------- */
+layout_TXT1:
+ .dw T1_MAP, 0x0000, T1_PAT, SPR_OAM, SPR_PAT
+
+layout_GFX1:
+ .dw G1_MAP, G1_COL, G1_PAT, SPR_OAM, SPR_PAT
+
+layout_GFX2:
+ .dw G2_MAP, G2_COL, G2_PAT, SPR_OAM, SPR_PAT
+
+layout_MC:
+ .dw MC_MAP, 0x0000, MC_PAT, SPR_OAM, SPR_PAT
+// --------------------------------------------------------------
 __endasm;
 } 
 
 
 
 
+/* =============================================================================
+SetBackMap
+Description:
+		Sets the address of the name table where the library writes 
+		(VDP_Layout.map), while the VDP keeps showing the current one (R#2).
+		Used for double buffering with FlipMap. 
+		The address must be a multiple of 0x400 and not overlap other tables.
+Input:	[unsigned int] VRAM address of the back name table
+Output:	- 
+============================================================================= */
+void SetBackMap(unsigned int vaddr) __naked
+{
+vaddr;	//HL
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SetBackMap
+#endif
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   (#_VDP_Layout),HL	//Name Table
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+FlipMap
+Description:
+		Waits for the vertical retrace (HALT) and shows the back name table 
+		(R#2). The name table shown until now becomes the back table.
+		Requires the interrupts enabled.
+Input:	-
+Output:	- 
+============================================================================= */
+void FlipMap(void) __naked
+{
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_FlipMap
+#endif
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   A,(#RG0SAV+2)		//front table / 0x400
+	add  A,A
+	add  A,A
+	ld   B,A				//B = high byte of the front table
+
+	ld   A,(#_VDP_Layout+1)	//back table
+	srl  A
+	srl  A
+	ld   C,#2
+
+	ei
+	halt					//vertical retrace
+	call writeVDP
+	ld   A,(#RG0SAV+2)
+	ld   (#_TMS_layoutRG),A	//VDP_Layout follows R#2
+
+	xor  A
+	ld   (#_VDP_Layout),A
+	ld   A,B
+	ld   (#_VDP_Layout+1),A	//the front table becomes the back table
+	ret
+__endasm;
+}
+
+
+
 /* =============================================================================
 SortG2map 
 Description: 
@@ -282,7 +610,14 @@ Output:	-
 void SortG2map(void) __naked
 {
 __asm
-	ld   HL,#G2_MAP
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SortG2map
+	ld   BC,#768
+	call TMS_StatWrite
+#endif
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout)	//Name Table
 	call _SetVDPtoWRITE
 	ld	 DE,#0x0300
 	xor  A
@@ -310,8 +645,15 @@ Output:	-
 void SortMCmap(void) __naked
 {
 __asm
-	ld   HL,#MC_MAP
-	call _SetVDPtoWRITE  //init VDP to Write to BASE15
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SortMCmap
+	ld   BC,#768
+	call TMS_StatWrite
+#endif
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout)	//Name Table
+	call _SetVDPtoWRITE
 	
 	ld   C,#0	//row
 	ld   D,#24
@@ -354,6 +696,11 @@ Output:	-
 void CLS(void) __naked
 {
 __asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_CLS
+#endif
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
 
 	ld   A,(#RG0SAV+1)	;reg1
 	bit  4,A			;M1=1 Text1
@@ -368,21 +715,21 @@ __asm
 ClearG1G2::
 	xor  A
 	ld   DE,#0x300		//32*24
-	ld   HL,#G1_MAP
+	ld   HL,(#_VDP_Layout)	//Name Table
 	jp   fillVR
  
 //MultiColor 64*48
 ClearMC::
 	xor  A
 	ld   DE,#0x600
-	ld   HL,#MC_PAT		//Pattern Table
+	ld   HL,(#_VDP_Layout+4)	//Pattern Table
 	jp   fillVR
  
 //Text1
 ClearT1::
 	xor  A
 	ld   DE,#0x3C0		//40*24
-	ld   HL,#T1_MAP
+	ld   HL,(#_VDP_Layout)	//Name Table
 	jp   fillVR
   
 __endasm;
@@ -413,21 +760,21 @@ ink;		//A
 background;	//L
 border;		//STack
 __asm
-	push IX
-	ld   IX,#0
-	add  IX,SP
-
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_COLOR
+#endif
 //save values in system vars
 	ld   (#FORCLR),A		//(14ts) ink color (foreground) 
 	ld   A,L				//( 5ts)
 	ld   (#BAKCLR),A		//(14ts) background color
-	ld   A,4(IX)			//(21ts)
+	ld   HL,#2				//(11ts)
+	add  HL,SP				//(12ts)
+	ld   A,(HL)				//( 8ts)
 	ld   (#BDRCLR),A		//(14ts) border color
-//total ----------------->68c
+//total ----------------->78c
 
 	call TMS_SetCOLORs
-
-	pop  IX
 __endasm;
 } 
 
@@ -446,16 +793,20 @@ void VPOKE(unsigned int vaddr, char value)
 vaddr;	//HL
 value;	//Stack
 __asm
-	push IX
-	ld   IX,#0
-	add  IX,SP
-  
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_VPOKE
+#endif
 	call _SetVDPtoWRITE
 	
-	ld   A,4(IX)
-	call _FastVPOKE
-	
-	pop  IX
+	ld   HL,#2
+	add  HL,SP
+	ld   A,(HL)		//value
+	out  (VDPVRAM),A
+#ifdef VDP_STATS_BUILD
+	ld   BC,#1
+	call TMS_StatWrite
+#endif
 __endasm;
 }
 
@@ -472,6 +823,10 @@ char VPEEK(unsigned int vaddr) __naked
 {
 vaddr;	//HL
 __asm	
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_VPEEK
+#endif
 
 
 /* =============================================================================
@@ -484,6 +839,7 @@ Regs:	-
 ============================================================================= */
 ReadByteFromVRAM::
 	call _SetVDPtoREAD
+	nop					//( 5ts) the VDP needs 29 T-states to read the value (4+5+11+5+8 = 33ts)
   
 /* =============================================================================
 FastVPEEK                                
@@ -496,6 +852,12 @@ Input    : --
 Output   : A - value
 ============================================================================= */ 
 _FastVPEEK::  
+#ifdef VDP_STATS_BUILD
+	push BC
+	ld   BC,#1
+	call TMS_StatRead
+	pop  BC
+#endif
 	in   A,(VDPVRAM)
 
 	ret 
@@ -528,6 +890,12 @@ Input:	A - value
 Output:	-
 ============================================================================= */
 _FastVPOKE::  
+#ifdef VDP_STATS_BUILD
+	push BC
+	ld   BC,#1
+	call TMS_StatWrite
+	pop  BC
+#endif
 	out  (VDPVRAM),A  
 	ret
 
@@ -540,8 +908,9 @@ __endasm;
 FillVRAM                               
 Description:
 		Fills an area of ​​VRAM with the same value.
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
 Input:	[unsigned int] VRAM address
-		[unsigned int] block size
+		[unsigned int] block size (0 = no transfer)
 		[char] Value to fill
 Output:	- 
 ============================================================================= */
@@ -551,15 +920,17 @@ vaddr;	//HL
 size;	//DE
 value;	//STack
 __asm
-	push IX
-	ld   IX,#0
-	add  IX,SP
-
-	ld   A,4(IX) ;value
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_FillVRAM
+#endif
+	push HL
+	ld   HL,#4
+	add  HL,SP
+	ld   A,(HL)		//value
+	pop  HL
 
 	call fillVR
-
-	pop  IX
 __endasm;
 } 
 
@@ -569,9 +940,10 @@ __endasm;
 CopyToVRAM
 Description:
 		Block transfer from memory to VRAM 
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
 Input:	[unsigned int] Memory address
 		[unsigned int] VRAM address
-		[unsigned int] block size
+		[unsigned int] block size (0 = no transfer)
 Output:	- 
 ============================================================================= */
 void CopyToVRAM(unsigned int addr, unsigned int vaddr, unsigned int size)
@@ -580,18 +952,84 @@ addr;	//HL
 vaddr;	//DE
 size;	//STack
 __asm
-	push IX
-	ld   IX,#0
-	add  IX,SP  
-
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_CopyToVRAM
+#endif
 	ex   DE,HL
 
-	ld   C,4(IX)	//size
-	ld   B,5(IX)
+	push HL
+	ld   HL,#4
+	add  HL,SP
+	ld   C,(HL)		//size
+	inc  HL
+	ld   B,(HL)
+	pop  HL
 
 	call LDIR2VRAM
+__endasm;
+} 
 
-	pop  IX
+
+
+/* =============================================================================
+CopyToVRAM_G2x3
+Description:
+		Copies a tileset to the three banks of the Graphic2 Pattern Table 
+		(G2_PAT_A/B/C) and its colors to the three banks of the Color Table 
+		(G2_COL_A/B/C), in a single call.
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
+Input:	[unsigned int] patterns Memory address
+		[unsigned int] colors Memory address
+		[unsigned int] block size (up to 2048)
+Output:	- 
+============================================================================= */
+void CopyToVRAM_G2x3(unsigned int pat, unsigned int col, unsigned int size)
+{
+pat;	//HL
+col;	//DE
+size;	//STack
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_CopyToVRAM_G2x3
+#endif
+	push DE
+	push HL
+	ld   HL,#6
+	add  HL,SP
+	ld   C,(HL)			//size
+	inc  HL
+	ld   B,(HL)
+
+	pop  DE				//patterns
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout+4)	//Pattern Table
+	call TMS_G2x3$
+
+	pop  DE				//colors
+	ld   HL,(#_VDP_Layout+2)	//Color Table
+	call TMS_G2x3$
+	jr   TMS_G2x3end$
+
+//Input: DE - Memory address; HL - VRAM address of bank A; BC - size
+TMS_G2x3$:
+	call TMS_G2bank$	//bank A
+	set  3,H			//bank B (+0x0800)
+	call TMS_G2bank$
+	res  3,H
+	set  4,H			//bank C (+0x1000)
+TMS_G2bank$:
+	push BC
+	push DE
+	push HL
+	call LDIR2VRAM
+	pop  HL
+	pop  DE
+	pop  BC
+	ret
+
+TMS_G2x3end$:
 __endasm;
 } 
 
@@ -601,9 +1039,10 @@ __endasm;
 CopyFromVRAM
 Description:
 		Block transfer from VRAM to memory
+		When the display is disabled (BLK=0), the fast unpaced loop is used.
 Input:	[unsigned int] VRAM address                     
 		[unsigned int] RAM address
-		[unsigned int] block size
+		[unsigned int] block size (0 = no transfer)
 Output:	-
 ============================================================================= */
 void CopyFromVRAM(unsigned int vaddr, unsigned int addr, unsigned int size)
@@ -612,127 +1051,464 @@ vaddr;	//HL
 addr;	//DE
 size;	//STack
 __asm
-  push IX
-  ld   IX,#0
-  add  IX,SP
-  
-  ld   C,4(IX)	//length
-  ld   B,5(IX)
-    
-  call GetBLOCKfromVRAM
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_CopyFromVRAM
+#endif
+	push HL
+	ld   HL,#4
+	add  HL,SP
+	ld   C,(HL)		//length
+	inc  HL
+	ld   B,(HL)
+	pop  HL
     
-  pop  IX
+	call GetBLOCKfromVRAM
 __endasm;
 }   
 
 
 
 /* =============================================================================
-GetVDP
+WriteVRAMbyte
 Description:
-		Gets the value in a VDP register.
-		Provides the mirror value of a VDP register stored in system variables.
-Input:	[char] register number (0-7)           
-Output:	[char] value
-Regs:	HL,DE
+		Writes a value to the video RAM. Same as VPOKE, with the parameters 
+		in registers (without stack).
+Input:	[char] value
+		[unsigned int] VRAM address
+Output:	- 
 ============================================================================= */
-char GetVDP(char reg) __naked
+void WriteVRAMbyte(char value, unsigned int vaddr) __naked
 {
-reg;	//A
+value;	//A
+vaddr;	//DE
 __asm
-readVDP::
-	ld   HL,#RG0SAV		//Mirror of VDP register 1
-	ld   E,A
-	ld   D,#0
-	add  HL,DE
-	ld   A,(HL)
-	ret
-__endasm;		
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_WriteVRAMbyte
+#endif
+	ex   DE,HL
+	jp   WriteByteToVRAM	//Input: HL<--VRAM address; A<--value
+__endasm;
 }
 
 
 
 /* =============================================================================
-SetVDP
+FillVRAMblock                               
 Description:
-		Writes a value to a VDP register and 
-		saves the value in the system variables.
-Input:	[char] register number (0-7)                    
-		[char] value
-Output:	-
+		Fills an area of ​​VRAM with the same value. Same as FillVRAM, with the 
+		parameters in a structure (without stack).
+Input:	[VRAM_FILL*] pointer to the parameters (vaddr, size, value)
+Output:	- 
 ============================================================================= */
-void SetVDP(char reg, char value) __naked
+void FillVRAMblock(VRAM_FILL* fill) __naked
 {
-reg;	//A
-value;	//L
-__asm      
-	ld   C,A	//reg
-	ld   A,L	//value
-  
+fill;	//HL
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_FillVRAMblock
+#endif
+	ld   C,(HL)
+	inc  HL
+	ld   B,(HL)			//BC = VRAM address
+	inc  HL
+	ld   E,(HL)
+	inc  HL
+	ld   D,(HL)			//DE = size
+	inc  HL
+	ld   A,(HL)			//A = value
+	ld   H,B
+	ld   L,C
+	jp   fillVR
+__endasm;
+}
+
+
 
 /* =============================================================================
-writeVDP
+CopyToVRAMblock
 Description:
-		Writes a value to a VDP register
-Input:	A  - value
-        C  - register number (0-7) 
-Output:	-
-Registers: IY, DE
+		Block transfer from memory to VRAM. Same as CopyToVRAM, with the 
+		parameters in a structure (without stack).
+Input:	[VRAM_BLOCK*] pointer to the parameters (addr, vaddr, size)
+Output:	- 
 ============================================================================= */
-writeVDP::
+void CopyToVRAMblock(VRAM_BLOCK* block) __naked
+{
+block;	//HL
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_CopyToVRAMblock
+#endif
+	call TMS_GetBLOCKparams	//Output: HL-->VRAM address; DE-->Memory address; BC-->size
+	jp   LDIR2VRAM
+__endasm;
+}
 
-	ld   IY,#RG0SAV
-	ld   E,C
-	ld   D,#0
-	add  IY,DE
-	ld   (IY),A ;save copy of vdp value in system variable
 
-	di
-	out  (VDPSTATUS),A
-	ld   A,C
-	or   #0b10000000	;add 128 to VDP register number
-	out  (VDPSTATUS),A
-	ei
-	ret
 
+/* =============================================================================
+CopyFromVRAMblock
+Description:
+		Block transfer from VRAM to memory. Same as CopyFromVRAM, with the 
+		parameters in a structure (without stack).
+Input:	[VRAM_BLOCK*] pointer to the parameters (addr, vaddr, size)
+Output:	- 
+============================================================================= */
+void CopyFromVRAMblock(VRAM_BLOCK* block) __naked
+{
+block;	//HL
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_CopyFromVRAMblock
+#endif
+	call TMS_GetBLOCKparams	//Output: HL-->VRAM address; DE-->Memory address; BC-->size
+	jp   GetBLOCKfromVRAM
+
+
+/* --------------------------------------------------------------------------
+Reads a VRAM_BLOCK structure
+Input:	HL - pointer to VRAM_BLOCK
+Output:	HL - VRAM address
+		DE - Memory address
+		BC - size
+Regs:	A
+-------------------------------------------------------------------------- */
+TMS_GetBLOCKparams:
+	ld   E,(HL)
+	inc  HL
+	ld   D,(HL)			//DE = Memory address
+	inc  HL
+	ld   C,(HL)
+	inc  HL
+	ld   B,(HL)			//BC = VRAM address
+	inc  HL
+	ld   A,(HL)
+	inc  HL
+	ld   H,(HL)
+	ld   L,A			//HL = size
+	push BC
+	ld   B,H
+	ld   C,L			//BC = size
+	pop  HL				//HL = VRAM address
+	ret
+__endasm;
+}
 
 
-;#####################################################
-;# I add here routines that cannot be added          #
-;# to their functions because these functions        #
-;# use the stack to pass in some values,             #
-;# it is necessary for the compiler to add code to   #
-;# the end of the function to recover the thread of  #
-;# execution.                                        #
-;#####         #######################################
-;    #         #
-;    #         #
-;    #         #
-;    #         #
-; ####         ####
-;  #             #
-;   #           #
-;    #         #
-;     #       #
-;      #     #
-;       #   #
-;        # #
-;         #
 
 /* =============================================================================
-fillVR                                
+ExecVRAMlist
 Description:
-		Fills an area of ​​VRAM with the same value.
-Input:	HL - VRAM address
-		DE - Size
-		A  - value
-Output:	-
-Regs:	BC
+		Executes a list of copy and fill commands in a single call.
+		The list can be in ROM and ends with a VCMD_END command.
+		Each command uses the fast loop when the display is disabled (BLK=0).
+Input:	[const VRAM_CMD*] pointer to the list of commands
+Output:	- 
 ============================================================================= */
-fillVR::
-  
-	ld   C,A
+void ExecVRAMlist(const VRAM_CMD* list) __naked
+{
+list;	//HL
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_ExecVRAMlist
+#endif
+TMS_VLISTloop$:
+	ld   A,(HL)				//op
+	or   A
+	ret  Z					//VCMD_END
+	inc  HL
+	ld   C,(HL)
+	inc  HL
+	ld   B,(HL)				//BC = VRAM address
+	inc  HL
+	ld   E,(HL)
+	inc  HL
+	ld   D,(HL)				//DE = size
+	inc  HL
+	push BC
+	ld   C,(HL)
+	inc  HL
+	ld   B,(HL)				//BC = Memory address or value
+	inc  HL
+	ex   (SP),HL			//(SP) = next command; HL = VRAM address
+	cp   #VCMD_FILL
+	jr   Z,TMS_VLISTfill$
+
+//VCMD_COPY
+	push DE
+	ld   D,B
+	ld   E,C				//DE = Memory address
+	pop  BC					//BC = size
+	call LDIR2VRAM
+	pop  HL
+	jr   TMS_VLISTloop$
+
+TMS_VLISTfill$:
+	ld   A,C				//value
+	call fillVR
+	pop  HL
+	jr   TMS_VLISTloop$
+__endasm;
+}
+
+
+
+/* =============================================================================
+SetVRAMlayout
+Description:
+		Moves the VRAM tables of the current screen mode. 
+		Writes the VDP registers 2 to 6 and copies the layout to VDP_Layout, 
+		which is used by all the functions of the library.
+		Call it after SCREEN. The tables are not initialized.
+		In Graphic2 mode, the color table and the pattern table can only be 
+		at 0x0000 or 0x2000.
+Input:	[const VRAM_LAYOUT*] pointer to the layout
+Output:	- 
+============================================================================= */
+void SetVRAMlayout(const VRAM_LAYOUT* layout) __naked
+{
+layout;	//HL
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SetVRAMlayout
+#endif
+	ld   DE,#RG0SAV+2
+	call TMS_SetLayout$
+
+//R#2 Name Table = map / 0x400
+	ld   A,(#_VDP_Layout+1)
+	srl  A
+	srl  A
+	ld   C,#2
+	call writeVDP
+
+//R#3 Color Table = col / 0x40
+	ld   HL,(#_VDP_Layout+2)
+	add  HL,HL
+	add  HL,HL
+	ld   A,(#RG0SAV)
+	bit  1,A				//M3=1 Graphic2?
+	ld   A,H
+	jr   Z,TMS_LAYOUTcol$
+	and  #0x80
+	ld   B,A
+	ld   A,(#RG0SAV+3)
+	and  #0x7F				//keeps the mask bits
+	or   B
+TMS_LAYOUTcol$:
+	ld   C,#3
+	call writeVDP
+
+//R#4 Pattern Table = pat / 0x800
+	ld   A,(#_VDP_Layout+5)
+	srl  A
+	srl  A
+	srl  A
+	ld   B,A
+	ld   A,(#RG0SAV)
+	bit  1,A				//M3=1 Graphic2?
+	ld   A,B
+	jr   Z,TMS_LAYOUTpat$
+	and  #0x04
+	ld   B,A
+	ld   A,(#RG0SAV+4)
+	and  #0x03				//keeps the mask bits
+	or   B
+TMS_LAYOUTpat$:
+	ld   C,#4
+	call writeVDP
+
+//R#5 Sprite Attribute Table = oam / 0x80
+	ld   HL,(#_VDP_Layout+6)
+	add  HL,HL
+	ld   A,H
+	ld   C,#5
+	call writeVDP
+
+//R#6 Sprite Pattern Table = spr / 0x800
+	ld   A,(#_VDP_Layout+9)
+	srl  A
+	srl  A
+	srl  A
+	ld   C,#6
+	call writeVDP
+
+	ld   HL,#RG0SAV+2
+	jp   TMS_SetLayoutRG$	//VDP_Layout belongs to the new registers
+__endasm;
+}
+
+
+
+/* =============================================================================
+GetVRAMlayout
+Description:
+		Provides the addresses of the VRAM tables used by the library. 
+		If SCREEN or SetVRAMlayout has not been called (the program keeps the 
+		screen mode of BASIC or MSX-DOS), or the registers 2 to 6 have been 
+		changed by other means (SetVDP, BIOS), it loads VDP_Layout from the 
+		VDP registers saved in the system variables (RG2SAV to RG6SAV).
+Input:	-
+Output:	[const VRAM_LAYOUT*] pointer to VDP_Layout
+============================================================================= */
+const VRAM_LAYOUT* GetVRAMlayout(void) __naked
+{
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_GetVRAMlayout
+#endif
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   DE,#_VDP_Layout
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+GetVDP
+Description:
+		Gets the value in a VDP register.
+		Provides the mirror value of a VDP register stored in system variables.
+Input:	[char] register number (0-7)           
+Output:	[char] value
+Regs:	HL,DE
+============================================================================= */
+char GetVDP(char reg) __naked
+{
+reg;	//A
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_GetVDP
+#endif
+readVDP::
+	ld   HL,#RG0SAV		//Mirror of VDP register 1
+	ld   E,A
+	ld   D,#0
+	add  HL,DE
+	ld   A,(HL)
+	ret
+__endasm;		
+}
 
+
+
+/* =============================================================================
+SetVDP
+Description:
+		Writes a value to a VDP register and 
+		saves the value in the system variables.
+Input:	[char] register number (0-7)                    
+		[char] value
+Output:	-
+============================================================================= */
+void SetVDP(char reg, char value) __naked
+{
+reg;	//A
+value;	//L
+__asm      
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SetVDP
+#endif
+	ld   C,A	//reg
+	ld   A,L	//value
+  
+
+/* =============================================================================
+writeVDP
+Description:
+		Writes a value to a VDP register
+Input:	A  - value
+        C  - register number (0-7) 
+Output:	-
+Registers: IY, DE
+============================================================================= */
+writeVDP::
+#ifdef VDP_STATS_BUILD
+	push HL
+	ld   HL,(#_VDP_Stats+STATS_REGISTERS)
+	inc  HL
+	ld   (#_VDP_Stats+STATS_REGISTERS),HL
+	pop  HL
+#endif
+
+	ld   IY,#RG0SAV
+	ld   E,C
+	ld   D,#0
+	add  IY,DE
+	ld   (IY),A ;save copy of vdp value in system variable
+
+	di
+	out  (VDPSTATUS),A
+	ld   A,C
+	or   #0b10000000	;add 128 to VDP register number
+	out  (VDPSTATUS),A
+	ei
+	ret
+
+
+
+;#####################################################
+;# I add here routines that cannot be added          #
+;# to their functions because these functions        #
+;# use the stack to pass in some values,             #
+;# it is necessary for the compiler to add code to   #
+;# the end of the function to recover the thread of  #
+;# execution.                                        #
+;#####         #######################################
+;    #         #
+;    #         #
+;    #         #
+;    #         #
+; ####         ####
+;  #             #
+;   #           #
+;    #         #
+;     #       #
+;      #     #
+;       #   #
+;        # #
+;         #
+
+/* =============================================================================
+fillVR                                
+Description:
+		Fills an area of ​​VRAM with the same value.
+Input:	HL - VRAM address
+		DE - Size (0 = no transfer)
+		A  - value
+Output:	-
+Regs:	BC
+============================================================================= */
+fillVR::
+  
+	ld   C,A
+	ld   A,(#RG0SAV+1)
+	and  #0b01000000		//BLK=0? (display disabled)
+	ld   A,C
+	jr   Z,fastFillVR
+
+	ld   A,D
+	or   E
+	ret  Z					//size 0: nothing (same as fastFillVR)
+
+#ifdef VDP_STATS_BUILD
+	push BC
+	ld   B,D
+	ld   C,E
+	call TMS_StatWrite
+	pop  BC
+#endif
 	call _SetVDPtoWRITE  
       
 	ld   A,C 
@@ -750,18 +1526,91 @@ TMS_VFILLloop$:
 	ret
 
 
+
+/* =============================================================================
+fastFillVR                                
+Description:
+		Fills an area of ​​VRAM with the same value, without the 29 T-states 
+		pacing. Only use it when the display is disabled (BLK=0) or when the 
+		whole block can be written during the vertical retrace.
+Input:	HL - VRAM address
+		DE - Size (0 = no transfer)
+		A  - value
+Output:	-
+Regs:	BC
+============================================================================= */
+fastFillVR::
+#ifdef VDP_STATS_BUILD
+	ld   B,D
+	ld   C,E
+	call TMS_StatWrite
+#endif
+
+	ld   C,A
+	call _SetVDPtoWRITE
+
+	ld   A,E
+	and  #0x07				//size MOD 8
+	jr   Z,TMS_VFILL8$
+	ld   B,A
+	ld   A,C
+TMS_VFILLrest$:
+	out  (VDPVRAM),A
+	djnz TMS_VFILLrest$
+
+TMS_VFILL8$:
+	srl  D
+	rr   E
+	srl  D
+	rr   E
+	srl  D
+	rr   E					//DE = blocks of 8 bytes
+	ld   A,D
+	or   E
+	ret  Z
+
+	ld   A,C
+	ld   B,E
+    dec  DE					//IF E=0 then D--
+    inc  D	
+TMS_VFILL8loop$:
+	out  (VDPVRAM),A		//(12ts)
+	out  (VDPVRAM),A
+	out  (VDPVRAM),A
+	out  (VDPVRAM),A
+	out  (VDPVRAM),A
+	out  (VDPVRAM),A
+	out  (VDPVRAM),A
+	out  (VDPVRAM),A
+    djnz TMS_VFILL8loop$	//(14/9ts)
+    dec  D
+    jp   NZ,TMS_VFILL8loop$
+	ret
+
+
 /* =============================================================================
 LDIR2VRAM
 Description:
 		Block transfer from memory to VRAM 
 Input:	DE - source Memory address
 		HL - target VRAM address
-		BC - block size
+		BC - block size (0 = no transfer)
 Output:	-
 Regs:	A
 ============================================================================= */
 LDIR2VRAM::
 
+	ld   A,(#RG0SAV+1)
+	and  #0b01000000		//BLK=0? (display disabled)
+	jr   Z,fastLDIR2VRAM
+
+	ld   A,B
+	or   C
+	ret  Z					//size 0: nothing (same as fastLDIR2VRAM)
+
+#ifdef VDP_STATS_BUILD
+	call TMS_StatWrite
+#endif
 	call _SetVDPtoWRITE
 
 	ex   DE,HL
@@ -781,20 +1630,91 @@ TMS_COPYBYTE_loop:
     dec  D
     jp   NZ,TMS_COPYBYTE_loop
 	ret
-    
 
-        
+
+
+/* =============================================================================
+fastLDIR2VRAM
+Description:
+		Block transfer from memory to VRAM, without the 29 T-states pacing.
+		Only use it when the display is disabled (BLK=0) or when the whole 
+		block can be written during the vertical retrace.
+Input:	DE - source Memory address
+		HL - target VRAM address
+		BC - block size (0 = no transfer)
+Output:	-
+Regs:	A
+============================================================================= */
+fastLDIR2VRAM::
+#ifdef VDP_STATS_BUILD
+	call TMS_StatWrite
+#endif
+
+	call _SetVDPtoWRITE
+
+	ex   DE,HL
+
+	ld   D,B
+	ld   E,C
+		
+	ld   C,#VDPVRAM
+
+	ld   A,E
+	and  #0x07				//size MOD 8
+	jr   Z,TMS_COPY8$
+	ld   B,A
+	otir
+
+TMS_COPY8$:
+	ld   A,E
+	and  #0xF8
+	ld   E,A
+	or   D
+	ret  Z
+	
+    ld   B,E				//B is a multiple of 8. Z is only set by the last OUTI
+    dec  DE					//IF E=0 then D--
+    inc  D	
+TMS_COPY8_loop$:
+	outi					//(18ts)
+	outi
+	outi
+	outi
+	outi
+	outi
+	outi
+	outi
+    jp   NZ,TMS_COPY8_loop$	//(11ts)
+	
+    dec  D
+    jp   NZ,TMS_COPY8_loop$
+	ret
+
+
+
 /* =============================================================================
 GetBLOCKfromVRAM
 Description: 
 		Block transfer from VRAM to memory.  
 Input:	HL - source VRAM address                     
 		DE - target RAM address
-		BC - block size
+		BC - block size (0 = no transfer)
 Output:	-
 Regs:	A        
 ============================================================================= */
 GetBLOCKfromVRAM::
+
+	ld   A,(#RG0SAV+1)
+	and  #0b01000000		//BLK=0? (display disabled)
+	jr   Z,fastGetBLOCKfromVRAM
+
+	ld   A,B
+	or   C
+	ret  Z					//size 0: nothing (same as fastGetBLOCKfromVRAM)
+
+#ifdef VDP_STATS_BUILD
+	call TMS_StatRead
+#endif
 	call _SetVDPtoREAD
 
 	ex   DE,HL
@@ -815,6 +1735,65 @@ VREAD_loop:
     jp   NZ,VREAD_loop
 	ret
 
+
+
+/* =============================================================================
+fastGetBLOCKfromVRAM
+Description: 
+		Block transfer from VRAM to memory, without the 29 T-states pacing.
+		Only use it when the display is disabled (BLK=0) or when the whole 
+		block can be read during the vertical retrace.
+Input:	HL - source VRAM address                     
+		DE - target RAM address
+		BC - block size (0 = no transfer)
+Output:	-
+Regs:	A        
+============================================================================= */
+fastGetBLOCKfromVRAM::
+#ifdef VDP_STATS_BUILD
+	call TMS_StatRead
+#endif
+
+	call _SetVDPtoREAD
+
+	ex   DE,HL
+
+	ld   D,B
+	ld   E,C
+
+	ld   C,#VDPVRAM
+
+	ld   A,E
+	and  #0x07				//size MOD 8
+	jr   Z,VREAD8$
+	ld   B,A
+	inir
+
+VREAD8$:
+	ld   A,E
+	and  #0xF8
+	ld   E,A
+	or   D
+	ret  Z
+
+    ld   B,E				//B is a multiple of 8. Z is only set by the last INI
+    dec  DE					//IF E=0 then D--
+    inc  D	
+VREAD8_loop$:
+	ini						//(18ts)
+	ini
+	ini
+	ini
+	ini
+	ini
+	ini
+	ini
+    jp   NZ,VREAD8_loop$	//(11ts)
+	
+    dec  D
+    jp   NZ,VREAD8_loop$
+	ret
+
 __endasm;
 }   
 
@@ -832,6 +1811,13 @@ void SetVDPtoREAD(unsigned int vaddr) __naked
 {
 vaddr;	//HL
 __asm
+#ifdef VDP_STATS_BUILD
+	push HL
+	ld   HL,(#_VDP_Stats+STATS_SETUPS)
+	inc  HL
+	ld   (#_VDP_Stats+STATS_SETUPS),HL
+	pop  HL
+#endif
 	ld   A,L
 	di
 	out  (VDPSTATUS),A
@@ -857,6 +1843,13 @@ void SetVDPtoWRITE(unsigned int vaddr) __naked
 {
 vaddr;	//HL
 __asm
+#ifdef VDP_STATS_BUILD
+	push HL
+	ld   HL,(#_VDP_Stats+STATS_SETUPS)
+	inc  HL
+	ld   (#_VDP_Stats+STATS_SETUPS),HL
+	pop  HL
+#endif
 	ld    A,L             //first 8bits from VRAM ADDR
 	di
 	out   (VDPSTATUS),A
@@ -889,24 +1882,33 @@ Output:	-
 void ClearSprites(void) __naked
 {
 __asm
-	ld   HL,#BASE8
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+
+//SCREEN: VDP_Layout is set before the registers are written
+TMS_ClearSprites$:
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_ClearSprites
+	ld   BC,#128
+	call TMS_StatWrite
+#endif
+	ld   HL,(#_VDP_Layout+6)	//Sprite Attribute Table
 	call _SetVDPtoWRITE 
 
 	ld   B,#32
 	ld   C,#SPRITES_YHIDDEN
 TMS_ClearOAMloop$:
-	ld   A,C			//( 5ts) 12+14+5= 31ts
+	ld   A,C			//( 5ts) 12+14+5 = 31ts
 	out  (VDPVRAM),A	//(12ts) attr Y (time for write 29 T-states)
-	xor  A				//( 8ts)
+	xor  A				//( 5ts)
 	nop					//( 5ts)
 	nop					//( 5ts)
+	nop					//( 5ts) 12+5+5+5+5 = 32ts
 	out  (VDPVRAM),A	//(12ts) attr X
-//	xor  A				//( 8ts) 12+8+5+5 = 30ts - 
 	inc  BC				//( 7ts) 12+7+5+5 = 29ts This instruction is added to create a delay up to 29 T-states (need for write to TMS9918A VRAM)
 	nop
 	nop
 	out  (VDPVRAM),A	//attr pattern number
-//	xor  A
 	dec  BC				//This instruction is added to create a delay up to 29 T-states (need for write to TMS9918A VRAM)
 	nop
 	nop
@@ -930,6 +1932,10 @@ void SetSpritesSize(char size) __naked
 {
 size;	//A	
 __asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SetSpritesSize
+#endif
 
 	ld   C,A
 	ld   A,(#RG0SAV+1)	//read vdp(1) from mem
@@ -962,6 +1968,10 @@ void SetSpritesZoom(char zoom) __naked
 {
 zoom;	//A	
 __asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_SetSpritesZoom
+#endif
   
 	ld   C,A
 	ld   A,(#RG0SAV+1)	//read vdp(1) from mem
@@ -1003,29 +2013,85 @@ y;			//Stack
 color;		//Stack
 pattern;	//Stack
 __asm
-	push IX
-	ld   IX,#0
-	add  IX,SP
-  
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_PUTSPRITE
+	ld   BC,#4
+	call TMS_StatWrite
+#endif
 	ld   C,L		//x
 
 	call GetSPRattrVADDR	//Input:A<--plane; Output:HL-->VRAM address
+	call _SetVDPtoWRITE
 
-	ld   A,4(IX)	//y
-	call WriteByteToVRAM	//Input:HL<--VRAM address; A<--value
-
-	ld   A,C		//x
-	call _FastVPOKE
+	ld   HL,#2
+	add  HL,SP
+	ld   A,(HL)				//y
+	out  (VDPVRAM),A		//(12ts)
+	inc  HL					//( 7ts)
+	ld   B,(HL)				//( 8ts) color
+	ld   A,C				//( 5ts) 12+7+8+5 = 32ts
+	out  (VDPVRAM),A		//x
 
-	ld   E,6(IX)	//Sprite pattern
+	inc  HL
+	ld   E,(HL)				//Sprite pattern
 	call GetSpritePattern	//Input:E; Output:A pattern position according to sprite size
-	call _FastVPOKE
+	out  (VDPVRAM),A		//(12ts)
+
+	ld   A,B				//( 5ts)
+	nop						//( 5ts)
+	nop						//( 5ts)
+	nop						//( 5ts) 12+5+5+5+5 = 32ts
+	out  (VDPVRAM),A		//color
+__endasm;
+}
 
-	ld   A,5(IX)	//color
-	call _FastVPOKE
 
-	pop  IX
-	
+
+/* =============================================================================
+PutSpriteAttr
+Description: 
+		Displays a Sprite on the screen. Same as PUTSPRITE, with the 
+		attributes in a structure (without stack).
+Input:	[char] sprite plane (0-31) 
+		[SPRITE_ATTR*] pointer to the attributes (y, x, pattern, color)
+Output:	-
+============================================================================= */
+void PutSpriteAttr(char plane, SPRITE_ATTR* attr) __naked
+{
+plane;	//A
+attr;	//DE
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_PutSpriteAttr
+	ld   BC,#4
+	call TMS_StatWrite
+#endif
+	push DE
+
+	call GetSPRattrVADDR	//Input:A<--plane; Output:HL-->VRAM address
+	call _SetVDPtoWRITE
+
+	pop  HL
+
+	ld   A,(HL)				//y
+	out  (VDPVRAM),A		//(12ts)
+	inc  HL					//( 7ts)
+	ld   A,(HL)				//( 8ts)
+	nop						//( 5ts) 12+7+8+5 = 32ts
+	out  (VDPVRAM),A		//x
+
+	inc  HL
+	ld   E,(HL)				//Sprite pattern
+	call GetSpritePattern	//Input:E; Output:A pattern position according to sprite size
+	out  (VDPVRAM),A		//(12ts)
+
+	inc  HL					//( 7ts)
+	ld   A,(HL)				//( 8ts)
+	nop						//( 5ts) 12+7+8+5 = 32ts
+	out  (VDPVRAM),A		//color
+	ret
 __endasm;
 }
 
@@ -1043,6 +2109,10 @@ unsigned int GetSPRattrVRAM(char plane) __naked
 {
 plane;		//A
 __asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_GetSPRattrVRAM
+#endif
 	call GetSPRattrVADDR	//Input: A-->Sprite plane; Output: HL-->VRAM addr
 	ex   DE,HL
 	ret
@@ -1053,7 +2123,8 @@ GetSPRattrVADDR::
 	add  A				//multiply x 4
 	ld   E,A
 	ld   D,#0
-	ld   HL,#SPR_OAM	//base 8/13/18 sprite attribute table
+	call TMS_CheckLayout	//no SCREEN/SetVRAMlayout: loads VDP_Layout from the registers
+	ld   HL,(#_VDP_Layout+6)	//Sprite Attribute Table
 	add  HL,DE
 	ret
 	
@@ -1082,4 +2153,297 @@ GetSpritePattern::
 	ret	
 	
 __endasm;
-}
\ No newline at end of file
+}
+
+
+
+
+/* #############################################################################
+##                                                          FRAME functions   ##
+################################################################################ */
+
+unsigned int TMS_lastFrame;		//JIFFY in the last WaitVBlank
+unsigned int TMS_dropped;		//lost frames
+
+
+
+/* =============================================================================
+InitFrameSync
+Description: 
+		Starts the count of frames of WaitVBlank and GetDroppedFrames.
+		Call it before the first WaitVBlank: the count is not initialized 
+		at startup (the RAM of the program is not cleared).
+Input:	-
+Output:	-
+============================================================================= */
+void InitFrameSync(void) __naked
+{
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_InitFrameSync
+#endif
+	ld   HL,(#JIFFY)
+	ld   (#_TMS_lastFrame),HL
+	ld   HL,#0
+	ld   (#_TMS_dropped),HL
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+WaitVBlank
+Description: 
+		Waits for the start of the vertical retrace.
+		- With the interrupts enabled, waits (HALT) until the BIOS interrupt 
+		  routine increments JIFFY.
+		- With the interrupts disabled, reads the F flag of the status 
+		  register S#0, saves it in STATFL (with the 5S and C flags of all 
+		  the reads) and increments JIFFY. If F is already set, the retrace 
+		  started before the call and it returns at once.
+		Counts the frames lost since the previous call.
+Input:	-
+Output:	-
+============================================================================= */
+void WaitVBlank(void) __naked
+{
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_WaitVBlank
+#endif
+	ld   A,I				//P/V = IFF2
+	jp   PE,TMS_VBLANKint$
+	ld   A,I				//NMOS Z80: P/V=0 if an interrupt was accepted in the first LD A,I
+	jp   PO,TMS_VBLANKpoll$	//interrupts disabled
+
+TMS_VBLANKint$:
+	ld   A,(#JIFFY)
+	ld   B,A
+TMS_VBLANKhalt$:
+	halt					//next interrupt
+	ld   A,(#JIFFY)
+	cp   B
+	jr   Z,TMS_VBLANKhalt$	//it was not the VDP interrupt
+	jr   TMS_VBLANKcount$
+
+//interrupts disabled: reads S#0
+TMS_VBLANKpoll$:
+	in   A,(VDPSTATUS)
+	or   A
+	jp   M,TMS_VBLANKflag$	//F=1: the retrace started before the call
+	and  #0x60
+	ld   B,A				//5S and C (cleared by each read)
+TMS_VBLANKwait$:
+	in   A,(VDPSTATUS)
+	ld   C,A
+	and  #0x60
+	or   B
+	ld   B,A
+	ld   A,C
+	or   A
+	jp   P,TMS_VBLANKwait$	//F=0
+	or   B					//with the 5S and C flags of the previous reads
+TMS_VBLANKflag$:
+	ld   (#STATFL),A
+	call TMS_IncJIFFY$
+
+//dropped += JIFFY - lastFrame - 1
+TMS_VBLANKcount$:
+	ld   DE,(#JIFFY)
+	ld   HL,(#_TMS_lastFrame)
+	ld   (#_TMS_lastFrame),DE
+	ex   DE,HL
+	or   A
+	sbc  HL,DE
+	dec  HL
+	ld   DE,(#_TMS_dropped)
+	add  HL,DE
+	ld   (#_TMS_dropped),HL
+	ret
+
+TMS_IncJIFFY$:
+	ld   HL,(#JIFFY)
+	inc  HL
+	ld   (#JIFFY),HL
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+GetFrameCount
+Description: 
+		Returns the frame counter (JIFFY).
+Input:	-
+Output:	[unsigned int] frames
+============================================================================= */
+unsigned int GetFrameCount(void) __naked
+{
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_GetFrameCount
+#endif
+	ld   DE,(#JIFFY)
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+GetDroppedFrames
+Description: 
+		Returns the frames lost in WaitVBlank since the previous call 
+		(frames where the program did not finish in time) and resets 
+		the count.
+Input:	-
+Output:	[unsigned int] lost frames
+============================================================================= */
+unsigned int GetDroppedFrames(void) __naked
+{
+__asm
+#ifdef VDP_STATS_BUILD
+	call TMS_StatCall
+	.db  VDPSTAT_GetDroppedFrames
+#endif
+	ld   DE,(#_TMS_dropped)
+	ld   HL,#0
+	ld   (#_TMS_dropped),HL
+	ret
+__endasm;
+}
+
+
+
+
+
+
+/* #############################################################################
+##                                                          STATS functions   ##
+################################################################################
+Instrumented build (compiled with -DVDP_STATS_BUILD): the public functions count 
+their calls, the bytes transferred, the VRAM address setups and the register 
+writes in VDP_Stats.
+---------------------------------------------------------------------------- */
+#ifdef VDP_STATS_BUILD
+
+/* =============================================================================
+GetVDPstats
+Description: 
+		Returns the statistics of the instrumented build, accumulated since 
+		the last ResetVDPstats. 
+		The calls made by other functions of the library are also counted.
+Input:	-
+Output:	[const VDP_STATS*] pointer to the statistics
+============================================================================= */
+const VDP_STATS* GetVDPstats(void) __naked
+{
+__asm
+	ld   DE,#_VDP_Stats
+	ret
+__endasm;
+}
+
+
+
+/* =============================================================================
+ResetVDPstats
+Description: 
+		Clears the statistics. 
+		Call it at the start of the program and at the start of each 
+		interval to be measured (e.g. after WaitVBlank).
+Input:	-
+Output:	-
+============================================================================= */
+void ResetVDPstats(void) __naked
+{
+__asm
+	ld   HL,#_VDP_Stats
+	ld   DE,#_VDP_Stats+1
+	ld   BC,#STATS_SIZE-1
+	ld   (HL),#0
+	ldir
+	ret
+
+
+
+/* --------------------------------------------------------------------------
+Counts a call to a function of the library
+Input:	the index of the function (VDPSTAT_xxx), in the byte after the CALL
+Regs:	-
+-------------------------------------------------------------------------- */
+TMS_StatCall:
+	ex   (SP),HL			//HL = index address; (SP) = HL
+	push AF
+	push DE
+	ld   E,(HL)
+	inc  HL
+	push HL					//return address
+	ld   D,#0
+	ld   HL,#_VDP_Stats+STATS_CALLS
+	add  HL,DE
+	add  HL,DE
+	inc  (HL)
+	jr   NZ,TMS_StatCallEND$
+	inc  HL
+	inc  (HL)
+TMS_StatCallEND$:
+	pop  HL
+	pop  DE
+	pop  AF
+	ex   (SP),HL
+	ret
+
+
+
+/* --------------------------------------------------------------------------
+Adds the bytes written to VRAM
+Input:	BC - bytes
+Regs:	-
+-------------------------------------------------------------------------- */
+TMS_StatWrite:
+	push HL
+	ld   HL,#_VDP_Stats+STATS_WRITTEN
+	jr   TMS_StatAdd$
+
+
+
+/* --------------------------------------------------------------------------
+Adds the bytes read from VRAM
+Input:	BC - bytes
+Regs:	-
+-------------------------------------------------------------------------- */
+TMS_StatRead:
+	push HL
+	ld   HL,#_VDP_Stats+STATS_READ
+
+//(HL) unsigned long += BC
+TMS_StatAdd$:
+	push AF
+	ld   A,(HL)
+	add  A,C
+	ld   (HL),A
+	inc  HL
+	ld   A,(HL)
+	adc  A,B
+	ld   (HL),A
+	inc  HL
+	ld   A,(HL)
+	adc  A,#0
+	ld   (HL),A
+	inc  HL
+	ld   A,(HL)
+	adc  A,#0
+	ld   (HL),A
+	pop  AF
+	pop  HL
+	ret
+__endasm;
+}
+
+#endif
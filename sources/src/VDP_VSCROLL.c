@@ -0,0 +1,144 @@
+/* ==============================================================================                                                                            
+# VDP_VSCROLL MSX Library (fR3eL Project)
+
+- Version: 1.1 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+Smooth vertical scroll (1 pixel) by rolling the patterns of the background.
+The background uses a set of tiles with a fixed tile above each one. 
+For each offset (0-7) there is a rolled copy of the set, and SetVScroll 
+writes it over the patterns of the set. Every 8 pixels the name table moves 
+one row (e.g. with VDP_SCROLL) and the offset returns to 0.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.1 (17/10/2026) SetVScroll only writes the colors in Graphic2 (M3=1).
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/msxSystemVariables.h"
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_VSCROLL.h"
+
+
+
+const char* VSCROLL_patterns;
+const char* VSCROLL_colors;
+unsigned int VSCROLL_offset;	//first pattern x 8
+unsigned int VSCROLL_size;		//count x 8
+
+
+
+void VSCROLL_CopyToBanks(unsigned int addr, unsigned int vaddr);
+
+
+
+/* =============================================================================
+BuildVScrollSet
+Description: 
+		Generates the 8 rolled copies (offset 0 to 7) of a set of tiles. 
+		In the copy of offset p, each tile shows the last p lines of the 
+		tile above it followed by its first 8-p lines.
+		Use it for the patterns and, in Graphic2, for the colors.
+Input:	[char*] target buffer (count x 64 bytes)
+		[const char*] tiles (count x 8 bytes)
+		[const char*] index of the tile above each tile (count bytes)
+		[char] number of tiles
+Output:	-
+============================================================================= */
+void BuildVScrollSet(char* rolled, const char* tiles, const char* above, char count)
+{
+	char offset;
+	char tile;
+	char line;
+	const char* upper;
+	const char* lower;
+	
+	for (offset = 0; offset < 8; offset++)
+	{
+		for (tile = 0; tile < count; tile++)
+		{
+			upper = tiles + (above[tile] << 3) + 8 - offset;
+			lower = tiles + (tile << 3);
+			for (line = 0; line < offset; line++) *rolled++ = *upper++;
+			for (; line < 8; line++) *rolled++ = *lower++;
+		}
+	}
+}
+
+
+
+/* =============================================================================
+InitVScroll
+Description: 
+		Sets the rolled copies of the background tiles (8 sets of count x 8 
+		bytes, in RAM or ROM) and the first pattern number they use.
+Input:	[const char*] rolled patterns
+		[const char*] rolled colors (0 = the colors do not roll; Graphic2 only)
+		[char] first pattern number
+		[char] number of tiles
+Output:	-
+============================================================================= */
+void InitVScroll(const char* patterns, const char* colors, char first, char count)
+{
+	VSCROLL_patterns = patterns;
+	VSCROLL_colors = colors;
+	VSCROLL_offset = first << 3;
+	VSCROLL_size = count << 3;
+}
+
+
+
+/* =============================================================================
+SetVScroll
+Description: 
+		Writes the rolled copy of an offset (0-7) to the pattern table (and 
+		to the color table in Graphic2) of the current mode. In Graphic2 it 
+		writes the three banks, except in GRAPHIC2_MASKED mode.
+		In Graphic1 the colors are not written, even if InitVScroll has 
+		them: the color table has one byte for each group of 8 patterns.
+		Call it in the vertical retrace. Every 8 pixels the name table 
+		must move one row in the same frame.
+		Cost: count x 8 bytes per table and bank, 29 T-states per byte.
+Input:	[char] offset (0-7)
+Output:	-
+============================================================================= */
+void SetVScroll(char offset)
+{
+	unsigned int set = offset * VSCROLL_size;
+	const VRAM_LAYOUT* layout = GetVRAMlayout();
+	
+	VSCROLL_CopyToBanks((unsigned int) VSCROLL_patterns + set, layout->pat + VSCROLL_offset);
+	if (VSCROLL_colors && (*(char*) RG0SAV & 0b00000010))	//M3=1 Graphic2: a color per line
+		VSCROLL_CopyToBanks((unsigned int) VSCROLL_colors + set, layout->col + VSCROLL_offset);
+}
+
+
+
+/* =============================================================================
+VSCROLL_CopyToBanks
+Description: 
+		Copies a set to the table. In Graphic2 mode to the three banks, or 
+		only to the first bank when the mask bits of R#4 are 0.
+Input:	[unsigned int] Memory address
+		[unsigned int] VRAM address in the first bank
+Output:	-
+============================================================================= */
+void VSCROLL_CopyToBanks(unsigned int addr, unsigned int vaddr)
+{
+	CopyToVRAM(addr, vaddr, VSCROLL_size);
+	if ((*(char*) RG0SAV & 0b00000010) && (*(char*) (RG0SAV + 4) & 0x03))	//M3=1 Graphic2 with 3 banks
+	{
+		CopyToVRAM(addr, vaddr + BANK1, VSCROLL_size);
+		CopyToVRAM(addr, vaddr + BANK2, VSCROLL_size);
+	}
+}
@@ -0,0 +1,230 @@
+/* ==============================================================================                                                                            
+# VDP_ZX0 MSX Library (fR3eL Project)
+
+- Version: 1.0 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: MSX
+- Environment: ROM, MSX-DOS or BASIC
+- Format: SDCC Relocatable object file (.rel)
+- Programming language: C and Z80 assembler
+- Compiler: SDCC 4.4 or newer 
+
+## Description:                                                              
+ZX0 decompression directly to VRAM.
+Based on the "standard" decompressor of ZX0 v2 by Einar Saukas (BSD-3).
+The literals are written with LDIR2VRAM. The back-references are read from 
+VRAM with GetBLOCKfromVRAM in blocks of up to ZX0_CHUNK bytes, through a 
+small buffer, and written again with LDIR2VRAM.
+
+Requires the VDP_TMS9918A Library.
+ 
+## History of versions (dd/mm/yyyy):
+
+- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include "../include/VDP_TMS9918A.h"
+#include "../include/VDP_ZX0.h"
+
+
+
+#define ZX0_CHUNK	32	//size of the buffer for the back-references
+
+
+
+char ZX0_buffer[ZX0_CHUNK];
+unsigned int ZX0_src;		//VRAM address of the back-reference
+unsigned int ZX0_dst;		//VRAM address of the output
+unsigned int ZX0_len;		//bytes left in the back-reference
+unsigned int ZX0_offset;	//distance of the back-reference
+char ZX0_n;					//bytes in the current block
+
+
+
+/* =============================================================================
+ZX0toVRAM
+Description: 
+		Decompresses data in ZX0 format (v2, by Einar Saukas) directly to 
+		VRAM. The back-references are read from the data already written 
+		to VRAM, so it does not need a window buffer in RAM.
+Input:	[unsigned int] compressed data Memory address
+		[unsigned int] VRAM address
+Output:	[unsigned int] next VRAM address after the decompressed data
+============================================================================= */
+unsigned int ZX0toVRAM(unsigned int addr, unsigned int vaddr) __naked
+{
+addr;	//HL
+vaddr;	//DE
+__asm
+	ld   BC,#0xFFFF			//default offset 1
+	push BC
+	inc  BC
+	ld   A,#0x80
+
+ZX0_literals$:
+	call ZX0_elias$			//length
+	call ZX0_literalsVRAM$
+	add  A,A				//copy from last offset or new offset?
+	jr   C,ZX0_newoffset$
+	call ZX0_elias$			//length
+
+ZX0_copy$:
+	ex   (SP),HL			//preserve source, restore offset
+	push HL					//preserve offset
+	add  HL,DE				//destination - offset
+	call ZX0_matchVRAM$
+	pop  HL					//restore offset
+	ex   (SP),HL			//preserve offset, restore source
+	add  A,A				//copy from literals or new offset?
+	jr   NC,ZX0_literals$
+
+ZX0_newoffset$:
+	pop  BC					//discard last offset
+	ld   C,#0xFE			//negative offset
+	call ZX0_eliasloop$		//offset MSB
+	inc  C
+	ret  Z					//end marker. DE = next VRAM address
+	ld   B,C
+	ld   C,(HL)				//offset LSB
+	inc  HL
+	rr   B					//last offset bit becomes first length bit
+	rr   C
+	push BC					//preserve new offset
+	ld   BC,#1				//length
+	call NC,ZX0_eliasbacktrack$
+	inc  BC
+	jr   ZX0_copy$
+
+//interlaced Elias gamma coding
+ZX0_elias$:
+	inc  C
+ZX0_eliasloop$:
+	add  A,A
+	jr   NZ,ZX0_eliasskip$
+	ld   A,(HL)				//load another group of 8 bits
+	inc  HL
+	rla
+ZX0_eliasskip$:
+	ret  C
+ZX0_eliasbacktrack$:
+	add  A,A
+	rl   C
+	rl   B
+	jr   ZX0_eliasloop$
+
+
+
+/* -----------------------------------------------------------------------------
+Literals: copies BC bytes from HL (Memory) to DE (VRAM).
+Output: HL and DE advanced, BC = 0, A preserved.
+----------------------------------------------------------------------------- */
+ZX0_literalsVRAM$:
+	push AF
+	push HL
+	ld   H,D
+	ld   L,E
+	add  HL,BC
+	ex   (SP),HL			//(SP) = next VRAM address
+	ex   DE,HL				//DE = source; HL = VRAM address
+	call LDIR2VRAM			//returns HL = next source
+	pop  DE
+	ld   BC,#0
+	pop  AF
+	ret
+
+
+
+/* -----------------------------------------------------------------------------
+Back-reference: copies BC bytes from HL (VRAM) to DE (VRAM).
+The source can overlap the output (distance < length): each block reads at 
+most <distance> bytes and repeats them in the buffer.
+Output: DE advanced, BC = 0, A preserved.
+----------------------------------------------------------------------------- */
+ZX0_matchVRAM$:
+	push AF
+	ld   (#_ZX0_len),BC
+	ld   (#_ZX0_src),HL
+	ex   DE,HL
+	ld   (#_ZX0_dst),HL
+	or   A
+	sbc  HL,DE
+	ld   (#_ZX0_offset),HL
+
+ZX0_block$:
+//n = MIN(length, ZX0_CHUNK)
+	ld   HL,(#_ZX0_len)
+	ld   A,H
+	or   A
+	jr   NZ,ZX0_nfull$
+	ld   A,L
+	cp   #ZX0_CHUNK
+	jr   C,ZX0_n$
+ZX0_nfull$:
+	ld   A,#ZX0_CHUNK
+ZX0_n$:
+	ld   (#_ZX0_n),A
+
+//r = MIN(n, offset) bytes read from VRAM
+	ld   C,A
+	ld   HL,(#_ZX0_offset)
+	ld   A,H
+	or   A
+	jr   NZ,ZX0_rn$
+	ld   A,L
+	cp   C
+	jr   C,ZX0_r$
+ZX0_rn$:
+	ld   A,C
+ZX0_r$:
+	ld   C,A
+	ld   B,#0
+	push BC
+	ld   HL,(#_ZX0_src)
+	ld   DE,#_ZX0_buffer
+	call GetBLOCKfromVRAM
+	pop  BC
+
+//repeats the pattern of r bytes up to n
+	ld   A,(#_ZX0_n)
+	sub  C
+	jr   Z,ZX0_write$
+	ld   HL,#_ZX0_buffer
+	ld   D,H
+	ld   E,L
+	ex   DE,HL
+	add  HL,BC
+	ex   DE,HL				//DE = buffer + r
+	ld   C,A
+	ldir
+
+ZX0_write$:
+	ld   A,(#_ZX0_n)
+	ld   C,A
+	ld   B,#0
+	ld   HL,(#_ZX0_dst)
+	push HL
+	add  HL,BC
+	ld   (#_ZX0_dst),HL
+	pop  HL
+	ld   DE,#_ZX0_buffer
+	call LDIR2VRAM
+
+	ld   A,(#_ZX0_n)
+	ld   C,A
+	ld   B,#0
+	ld   HL,(#_ZX0_src)
+	add  HL,BC
+	ld   (#_ZX0_src),HL
+	ld   HL,(#_ZX0_len)
+	or   A
+	sbc  HL,BC
+	ld   (#_ZX0_len),HL
+	jr   NZ,ZX0_block$
+
+	ld   DE,(#_ZX0_dst)
+	ld   B,H
+	ld   C,L				//BC = 0
+	pop  AF
+	ret
+__endasm;
+}
@@ -0,0 +1,177 @@
+/* =============================================================================
+# Benchmark.c
+Version: 1.0 (17/10/2026)
+Architecture: vdpsim (Z80 + TMS9918A model, see tools/vdpsim)
+Format: Intel HEX (code at 0x0200, data at 0xC000)
+Programming language: C and Z80 assembler
+Compiler: SDCC 4.4 or newer
+
+## Description:
+	Benchmark of the VDP_TMS9918A MSX Library (fR3eL Project).
+	Each measure writes its name in port 0x2D and is enclosed between an OUT to
+	port 0x2E (start) and an OUT to port 0x2F (stop). vdpsim writes one CSV row
+	per measure (see MAKEFILE.BAT/bench.sh, output in results.csv).
+	The times include the code that SDCC generates to pass the parameters.
+
+## History of versions (dd/mm/yyyy):
+- v1.0 (17/10/2026)
+============================================================================= */
+#include "VDP_TMS9918A.h"
+
+
+__sfr __at 0x2D BENCH_NAME;		// name of the next measure ('\n' ends it)
+__sfr __at 0x2E BENCH_START;	// starts the measure
+__sfr __at 0x2F BENCH_STOP;		// ends the measure and writes a row
+
+
+#define MEASURE(code)	BENCH_START = 0; code; BENCH_STOP = 0
+
+
+const unsigned int SIZES[] = {1, 8, 32, 256, 2048};
+#define SIZES_COUNT	5
+
+
+char BUFFER[2048];
+
+SPRITE_ATTR SPRITE = {100, 120, 4, 15};
+
+
+
+void Name(char* text)
+{
+	while (*text) BENCH_NAME = *text++;
+}
+
+
+
+void NameNumber(unsigned int value)
+{
+	char digits[6];
+	char i = 0;
+	do {
+		digits[i++] = '0' + (value % 10);
+		value /= 10;
+	} while (value);
+	while (i) BENCH_NAME = digits[--i];
+}
+
+
+
+void NameEnd(void)
+{
+	BENCH_NAME = '\n';
+}
+
+
+
+void DisplayOn(void)
+{
+	SetVDP(1, GetVDP(1) | 0x40);
+}
+
+
+
+void DisplayOff(void)
+{
+	SetVDP(1, GetVDP(1) & 0xBF);
+}
+
+
+
+// FillVRAM, CopyToVRAM and CopyFromVRAM with the display enabled (suffix "on") or disabled ("off")
+void Transfers(char* suffix)
+{
+	char i;
+	unsigned int size;
+
+	for (i = 0; i < SIZES_COUNT; i++)
+	{
+		size = SIZES[i];
+
+		Name("FillVRAM_"); NameNumber(size); Name(suffix); NameEnd();
+		MEASURE(FillVRAM(0x0000, size, 0x55));
+
+		Name("CopyToVRAM_"); NameNumber(size); Name(suffix); NameEnd();
+		MEASURE(CopyToVRAM((unsigned int) BUFFER, 0x0000, size));
+
+		Name("CopyFromVRAM_"); NameNumber(size); Name(suffix); NameEnd();
+		MEASURE(CopyFromVRAM(0x0000, (unsigned int) BUFFER, size));
+	}
+
+	Name("CopyToVRAM_G2x3_256"); Name(suffix); NameEnd();
+	MEASURE(CopyToVRAM_G2x3((unsigned int) BUFFER, (unsigned int) BUFFER, 256));
+}
+
+
+
+void main(void)
+{
+	char value;
+	unsigned int vaddr;
+
+	// screen modes
+	Name("SCREEN_TEXT1"); NameEnd();
+	MEASURE(SCREEN(TEXT1));
+	Name("CLS_TEXT1"); NameEnd();
+	MEASURE(CLS());
+
+	Name("SCREEN_MULTICOLOR"); NameEnd();
+	MEASURE(SCREEN(MULTICOLOR));
+	Name("CLS_MULTICOLOR"); NameEnd();
+	MEASURE(CLS());
+	Name("SortMCmap"); NameEnd();
+	MEASURE(SortMCmap());
+
+	Name("SCREEN_GRAPHIC2_MASKED"); NameEnd();
+	MEASURE(SCREEN(GRAPHIC2_MASKED));
+
+	Name("SCREEN_GRAPHIC1"); NameEnd();
+	MEASURE(SCREEN(GRAPHIC1));
+	Name("CLS_GRAPHIC1"); NameEnd();
+	MEASURE(CLS());
+
+	Name("SCREEN_GRAPHIC2"); NameEnd();
+	MEASURE(SCREEN(GRAPHIC2));
+	Name("CLS_GRAPHIC2"); NameEnd();
+	MEASURE(CLS());
+	Name("SortG2map"); NameEnd();
+	MEASURE(SortG2map());
+
+	// registers
+	Name("COLOR"); NameEnd();
+	MEASURE(COLOR(15, 4, 5));
+	Name("SetVDP"); NameEnd();
+	MEASURE(SetVDP(7, 0x15));
+	Name("GetVDP"); NameEnd();
+	MEASURE(value = GetVDP(1));
+
+	// bytes
+	Name("SetVDPtoWRITE"); NameEnd();
+	MEASURE(SetVDPtoWRITE(0x1800));
+	Name("SetVDPtoREAD"); NameEnd();
+	MEASURE(SetVDPtoREAD(0x1800));
+	Name("VPOKE"); NameEnd();
+	MEASURE(VPOKE(0x1800, 'A'));
+	Name("WriteVRAMbyte"); NameEnd();
+	MEASURE(WriteVRAMbyte('A', 0x1800));
+	Name("VPEEK"); NameEnd();
+	MEASURE(value = VPEEK(0x1800));
+
+	// blocks
+	Transfers("_on");
+	DisplayOff();
+	Transfers("_off");
+	DisplayOn();
+
+	// sprites
+	Name("ClearSprites"); NameEnd();
+	MEASURE(ClearSprites());
+	Name("PUTSPRITE"); NameEnd();
+	MEASURE(PUTSPRITE(3, 120, 100, 15, 4));
+	Name("PutSpriteAttr"); NameEnd();
+	MEASURE(PutSpriteAttr(3, &SPRITE));
+	Name("GetSPRattrVRAM"); NameEnd();
+	MEASURE(vaddr = GetSPRattrVRAM(3));
+
+	BUFFER[0] = value + (char)vaddr;
+}
@@ -0,0 +1,15 @@
+#!/bin/sh
+# Benchmark of the VDP_TMS9918A Library
+# Requires SDCC 4.4 or newer and a C compiler for the host
+# Output: results.csv
+set -e
+cd "$(dirname "$0")"
+mkdir -p build
+${CC:-cc} -std=c99 -O2 -o build/vdpsim ../vdpsim/vdpsim.c
+sdasz80 -o build/crt0_bench.rel crt0_bench.s
+sdcc -mz80 -c -o build/ ../../sources/src/VDP_TMS9918A.c
+sdcc -mz80 -c -o build/ -I../../sources/include Benchmark.c
+sdcc -mz80 -o build/Benchmark.ihx --code-loc 0x0200 --data-loc 0xC000 --no-std-crt0 build/crt0_bench.rel build/VDP_TMS9918A.rel build/Benchmark.rel
+build/vdpsim -t
+build/vdpsim -s build/Benchmark.map build/Benchmark.ihx > results.csv
+cat results.csv
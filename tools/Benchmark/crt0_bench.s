@@ -0,0 +1,65 @@
+;------------------------------------------------------------------------------
+; crt0 for the benchmark of the VDP_TMS9918A Library (runs in tools/vdpsim)
+; 64K of RAM from address 0x0000. There is no BIOS: RDSLT returns 0 (MSX1).
+; The program ends with HALT after main.
+; _DATA is cleared (vdpsim clears the RAM, but an MSX does not).
+;------------------------------------------------------------------------------
+	.module crt0
+	.globl	_main
+
+	.area	_HEADER (ABS)
+	.org	0x0000
+	jp		init
+
+	.org	0x000C			; RDSLT
+	xor		a
+	ret
+
+	.org	0x0100
+init:
+	di
+	ld		sp,#0xF380		; below the MSX system variables used by the library
+	call	gsinit
+	call	_main
+	halt
+
+	;; Ordering of segments for the linker.
+	.area	_HOME
+	.area	_CODE
+	.area	_INITIALIZER
+	.area	_GSINIT
+	.area	_GSFINAL
+
+	.area	_DATA
+	.area	_INITIALIZED
+	.area	_BSEG
+	.area	_BSS
+	.area	_HEAP
+
+	.area	_GSINIT
+gsinit::
+	ld		bc,#l__INITIALIZER
+	ld		a,b
+	or		a,c
+	jr		Z,gsinit_next
+	ld		de,#s__INITIALIZED
+	ld		hl,#s__INITIALIZER
+	ldir
+gsinit_next:
+
+	ld		bc,#l__DATA			; clears _DATA
+	ld		a,b
+	or		a,c
+	jr		Z,gsinit_data
+	ld		hl,#s__DATA
+	ld		(hl),#0
+	dec		bc
+	ld		a,b
+	or		a,c
+	jr		Z,gsinit_data
+	ld		de,#s__DATA+1
+	ldir
+gsinit_data:
+
+	.area	_GSFINAL
+	ret
@@ -0,0 +1,1616 @@
+/* =============================================================================
+# vdpsim
+
+- Version: 1.2 (17/10/2026)
+- Author: mvac7/303bcn
+- Architecture: Host tool (C99)
+- Format: Command line program
+- Description:
+	Z80 and TMS9918A model used to benchmark the VDP_TMS9918A MSX Library.
+	It runs an SDCC program (Intel HEX) from address 0x0000 in 64K of flat RAM
+	until the first HALT, counting the T-states of the MSX (one wait state in
+	each M1 cycle). Ports 0x98 and 0x99 are connected to a TMS9918A model
+	(16K VRAM, address latch, read-ahead buffer and registers).
+
+	Benchmark ports (see tools/Benchmark/Benchmark.c):
+	- OUT 0x2D: one character of the name of the next measure ('\n' ends it).
+	- OUT 0x2E: starts the measure (after this instruction).
+	- OUT 0x2F: ends the measure (before this instruction) and writes a CSV row.
+
+	CSV columns:
+	name,tstates,bytes,tstates_per_byte,setups,registers,violations
+	- bytes: VRAM bytes written or read through port 0x98.
+	- setups: VRAM address setups (second write in port 0x99 with bit 7 = 0).
+	- registers: VDP register writes.
+	- violations: VRAM accesses too close to the previous one.
+
+	Timing check:
+	Each VRAM access (port 0x98 and the prefetch of a read address setup) must
+	be at least VRAM_GAP_ACTIVE T-states after the previous one when the
+	display is enabled (BLK=1), and VRAM_GAP_BLANK when it is disabled.
+	By default the whole frame is taken as active display (worst case, the
+	code does not know where the beam is). With -b, the lines 192 to 261 of an
+	NTSC frame (228 T-states per line) use VRAM_GAP_BLANK.
+	Each violation is written to stderr (once per address) with the PC and,
+	with -s, the nearest symbol of the .map or .noi file of the program.
+
+	Usage:
+	vdpsim [-b] [-s program.map|.noi] program.ihx > results.csv
+	vdpsim -t		runs the self-test (timing check and VRAM contents)
+
+- History of versions (dd/mm/yyyy):
+	- v1.2 (17/10/2026) Self-test: FlushScroll fixtures that check the name table
+	- v1.1 (17/10/2026) Added the VRAM access timing check
+	- v1.0 (17/10/2026) First version
+============================================================================= */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+
+
+#define FC	0x01
+#define FN	0x02
+#define FPV	0x04
+#define FH	0x10
+#define FZ	0x40
+#define FS	0x80
+
+#define MAX_TSTATES	4000000000ULL	// stops a program that does not reach HALT
+
+#define VRAM_GAP_ACTIVE	29		// minimum T-states between VRAM accesses (active display)
+#define VRAM_GAP_BLANK	8		// minimum T-states between VRAM accesses (BLK=0 or retrace)
+
+#define LINE_TSTATES	228
+#define FRAME_LINES		262
+#define ACTIVE_LINES	192
+
+#define MAX_SYMBOLS		8192
+#define MAX_REPORTED	256
+
+
+
+// ---------------------------------------------------------------- Z80 state
+static uint8_t mem[0x10000];
+
+static struct {
+	uint8_t a, f, b, c, d, e, h, l;
+	uint8_t a_, f_, b_, c_, d_, e_, h_, l_;
+	uint16_t ix, iy, sp, pc;
+	uint8_t i, r, iff1, iff2, im, halted;
+} z;
+
+static unsigned long long T;	// T-states since reset
+static unsigned long long T0;	// T-states at the start of the current instruction
+static uint16_t PC0;			// address of the current instruction
+static int idx;					// 0 = HL, 1 = IX, 2 = IY
+static uint8_t parity[256];		// FPV when the number of bits is even
+
+
+
+// ---------------------------------------------------------------- VDP state
+static struct {
+	uint8_t vram[0x4000];
+	uint8_t reg[8];
+	uint8_t status;
+	uint16_t addr;
+	uint8_t latch;		// 1 = first byte of port 0x99 received
+	uint8_t latchValue;
+	uint8_t readAhead;
+	unsigned long long lastAccess;
+	uint8_t accessed;	// 1 = lastAccess is valid
+} vdp;
+
+static struct {
+	unsigned long bytes;
+	unsigned long setups;
+	unsigned long registers;
+	unsigned long violations;
+} count;
+
+static int beamMode;			// -b: the retrace lines use VRAM_GAP_BLANK
+static int quiet;				// self-test: no report of each violation
+
+static struct {
+	uint16_t addr;
+	char name[48];
+} symbols[MAX_SYMBOLS];
+static int symbolCount;
+
+static uint16_t reported[MAX_REPORTED];
+static int reportedCount;
+
+
+
+// ---------------------------------------------------------------- benchmark
+static char benchName[64];
+static int benchNameLen;
+static int benchArm;			// 1 = start the measure at the end of this instruction
+static int benchRunning;
+static unsigned long long benchStart;
+static unsigned long benchBytes, benchSetups, benchRegisters, benchViolations;
+static int benchRows;
+
+
+
+
+/* =============================================================================
+ VDP model
+============================================================================= */
+
+static const char* Symbol(uint16_t addr)
+{
+	static char text[64];
+	int i, best = -1;
+
+	for (i = 0; i < symbolCount; i++)
+		if (symbols[i].addr <= addr && (best < 0 || symbols[i].addr > symbols[best].addr)) best = i;
+
+	if (best < 0) return "";
+	if (symbols[best].addr == addr) snprintf(text, sizeof(text), " (%s)", symbols[best].name);
+	else snprintf(text, sizeof(text), " (%s+0x%X)", symbols[best].name, addr - symbols[best].addr);
+	return text;
+}
+
+
+
+static int InActiveDisplay(unsigned long long t)
+{
+	if (!(vdp.reg[1] & 0x40)) return 0;		// BLK=0
+	if (!beamMode) return 1;
+	return (t / LINE_TSTATES) % FRAME_LINES < ACTIVE_LINES;
+}
+
+
+
+// checks the time from the previous VRAM access (t = T-states of the I/O cycle)
+static void VRAMaccess(unsigned long long t)
+{
+	unsigned long long gap = t - vdp.lastAccess;
+	unsigned int minimum = InActiveDisplay(t) ? VRAM_GAP_ACTIVE : VRAM_GAP_BLANK;
+	int i;
+
+	if (vdp.accessed && gap < minimum)
+	{
+		count.violations++;
+		for (i = 0; i < reportedCount && reported[i] != PC0; i++);
+		if (i == reportedCount && !quiet)
+		{
+			if (reportedCount < MAX_REPORTED) reported[reportedCount++] = PC0;
+			fprintf(stderr, "vdpsim: VRAM access %llu T-states after the previous one (minimum %u) at PC=%04X%s",
+				gap, minimum, PC0, Symbol(PC0));
+			if (benchRunning) fprintf(stderr, " in %s", benchName);
+			fprintf(stderr, "\n");
+		}
+	}
+
+	vdp.lastAccess = t;
+	vdp.accessed = 1;
+}
+
+
+
+static void VDPout(uint8_t port, uint8_t value, unsigned long long t)
+{
+	if (port == 0x98)
+	{
+		vdp.vram[vdp.addr] = value;
+		vdp.readAhead = value;
+		vdp.addr = (vdp.addr + 1) & 0x3FFF;
+		vdp.latch = 0;
+		count.bytes++;
+		VRAMaccess(t);
+		return;
+	}
+
+	if (!vdp.latch)
+	{
+		vdp.latchValue = value;
+		vdp.latch = 1;
+		return;
+	}
+
+	vdp.latch = 0;
+	if (value & 0x80)
+	{
+		vdp.reg[value & 0x07] = vdp.latchValue;
+		count.registers++;
+		return;
+	}
+
+	vdp.addr = ((value & 0x3F) << 8) | vdp.latchValue;
+	count.setups++;
+	if (!(value & 0x40))
+	{
+		// read setup: the VDP fills the read-ahead buffer
+		vdp.readAhead = vdp.vram[vdp.addr];
+		vdp.addr = (vdp.addr + 1) & 0x3FFF;
+		VRAMaccess(t);
+	}
+}
+
+
+
+static uint8_t VDPin(uint8_t port, unsigned long long t)
+{
+	uint8_t value;
+
+	vdp.latch = 0;
+	if (port == 0x98)
+	{
+		value = vdp.readAhead;
+		vdp.readAhead = vdp.vram[vdp.addr];
+		vdp.addr = (vdp.addr + 1) & 0x3FFF;
+		count.bytes++;
+		VRAMaccess(t);
+		return value;
+	}
+
+	value = vdp.status;
+	vdp.status &= 0x1F;
+	return value;
+}
+
+
+
+
+/* =============================================================================
+ Benchmark ports
+============================================================================= */
+
+static void BenchStop(void)
+{
+	unsigned long long time = T0 - benchStart;
+	unsigned long bytes = count.bytes - benchBytes;
+
+	if (!benchRunning) return;
+	benchRunning = 0;
+
+	printf("%s,%llu,%lu,", benchName, time, bytes);
+	if (bytes) printf("%.2f", (double)time / bytes);
+	printf(",%lu,%lu,%lu\n", count.setups - benchSetups, count.registers - benchRegisters,
+		count.violations - benchViolations);
+	benchRows++;
+}
+
+
+
+static void BenchOut(uint8_t port, uint8_t value)
+{
+	switch (port)
+	{
+		case 0x2D:
+			if (value == '\n' || value == 0)
+			{
+				benchNameLen = 0;
+				break;
+			}
+			if (benchNameLen == 0) benchName[0] = 0;
+			if (benchNameLen < (int)sizeof(benchName) - 1)
+			{
+				benchName[benchNameLen++] = (char)value;
+				benchName[benchNameLen] = 0;
+			}
+			break;
+
+		case 0x2E:
+			benchArm = 1;
+			break;
+
+		case 0x2F:
+			BenchStop();
+			break;
+	}
+}
+
+
+
+
+/* =============================================================================
+ I/O
+ t = T-states of the I/O cycle
+============================================================================= */
+
+static void PortOut(uint8_t port, uint8_t value, unsigned long long t)
+{
+	if (port == 0x98 || port == 0x99) VDPout(port, value, t);
+	else BenchOut(port, value);
+}
+
+
+
+static uint8_t PortIn(uint8_t port, unsigned long long t)
+{
+	if (port == 0x98 || port == 0x99) return VDPin(port, t);
+	return 0xFF;
+}
+
+
+
+
+/* =============================================================================
+ Z80
+============================================================================= */
+
+static uint8_t fetch(void)
+{
+	return mem[z.pc++];
+}
+
+
+
+static uint16_t fetch16(void)
+{
+	uint16_t value = mem[z.pc] | (mem[(uint16_t)(z.pc + 1)] << 8);
+	z.pc += 2;
+	return value;
+}
+
+
+
+static uint16_t rd16(uint16_t addr)
+{
+	return mem[addr] | (mem[(uint16_t)(addr + 1)] << 8);
+}
+
+
+
+static void wr16(uint16_t addr, uint16_t value)
+{
+	mem[addr] = (uint8_t)value;
+	mem[(uint16_t)(addr + 1)] = value >> 8;
+}
+
+
+
+static void push(uint16_t value)
+{
+	z.sp -= 2;
+	wr16(z.sp, value);
+}
+
+
+
+static uint16_t pop(void)
+{
+	uint16_t value = rd16(z.sp);
+	z.sp += 2;
+	return value;
+}
+
+
+
+static void incR(void)
+{
+	z.r = (z.r & 0x80) | ((z.r + 1) & 0x7F);
+}
+
+
+
+static uint16_t getHL(void)
+{
+	if (idx == 1) return z.ix;
+	if (idx == 2) return z.iy;
+	return (z.h << 8) | z.l;
+}
+
+
+
+static void setHL(uint16_t value)
+{
+	if (idx == 1) z.ix = value;
+	else if (idx == 2) z.iy = value;
+	else { z.h = value >> 8; z.l = (uint8_t)value; }
+}
+
+
+
+// BC, DE, HL/IX/IY, SP
+static uint16_t getRP(int p)
+{
+	switch (p)
+	{
+		case 0: return (z.b << 8) | z.c;
+		case 1: return (z.d << 8) | z.e;
+		case 2: return getHL();
+	}
+	return z.sp;
+}
+
+
+
+static void setRP(int p, uint16_t value)
+{
+	switch (p)
+	{
+		case 0: z.b = value >> 8; z.c = (uint8_t)value; break;
+		case 1: z.d = value >> 8; z.e = (uint8_t)value; break;
+		case 2: setHL(value); break;
+		default: z.sp = value;
+	}
+}
+
+
+
+// BC, DE, HL/IX/IY, AF
+static uint16_t getRP2(int p)
+{
+	if (p == 3) return (z.a << 8) | z.f;
+	return getRP(p);
+}
+
+
+
+static void setRP2(int p, uint16_t value)
+{
+	if (p == 3) { z.a = value >> 8; z.f = (uint8_t)value; }
+	else setRP(p, value);
+}
+
+
+
+// B, C, D, E, H/IXh/IYh, L/IXl/IYl, -, A
+static uint8_t getR(int r, int useIndex)
+{
+	switch (r)
+	{
+		case 0: return z.b;
+		case 1: return z.c;
+		case 2: return z.d;
+		case 3: return z.e;
+		case 4: return (useIndex && idx) ? getHL() >> 8 : z.h;
+		case 5: return (useIndex && idx) ? (uint8_t)getHL() : z.l;
+	}
+	return z.a;
+}
+
+
+
+static void setR(int r, uint8_t value, int useIndex)
+{
+	switch (r)
+	{
+		case 0: z.b = value; break;
+		case 1: z.c = value; break;
+		case 2: z.d = value; break;
+		case 3: z.e = value; break;
+		case 4:
+			if (useIndex && idx) setHL((getHL() & 0x00FF) | (value << 8));
+			else z.h = value;
+			break;
+		case 5:
+			if (useIndex && idx) setHL((getHL() & 0xFF00) | value);
+			else z.l = value;
+			break;
+		default: z.a = value;
+	}
+}
+
+
+
+// (HL) or (IX+d)/(IY+d): reads the displacement
+static uint16_t memAddr(void)
+{
+	if (idx) return getHL() + (int8_t)fetch();
+	return getHL();
+}
+
+
+
+static uint8_t flagsSZP(uint8_t value)
+{
+	return (value & FS) | (value ? 0 : FZ) | parity[value];
+}
+
+
+
+static void add8(uint8_t value, int carry)
+{
+	int result = z.a + value + carry;
+	uint8_t f = 0;
+
+	if (!(result & 0xFF)) f |= FZ;
+	if (result & 0x80) f |= FS;
+	if ((z.a ^ value ^ result) & 0x10) f |= FH;
+	if ((~(z.a ^ value) & (z.a ^ result)) & 0x80) f |= FPV;
+	if (result & 0x100) f |= FC;
+	z.a = (uint8_t)result;
+	z.f = f;
+}
+
+
+
+static uint8_t sub8(uint8_t a, uint8_t value, int carry)
+{
+	int result = a - value - carry;
+	uint8_t f = FN;
+
+	if (!(result & 0xFF)) f |= FZ;
+	if (result & 0x80) f |= FS;
+	if ((a ^ value ^ result) & 0x10) f |= FH;
+	if (((a ^ value) & (a ^ result)) & 0x80) f |= FPV;
+	if (result & 0x100) f |= FC;
+	z.f = f;
+	return (uint8_t)result;
+}
+
+
+
+static void alu(int op, uint8_t value)
+{
+	switch (op)
+	{
+		case 0: add8(value, 0); break;
+		case 1: add8(value, z.f & FC); break;
+		case 2: z.a = sub8(z.a, value, 0); break;
+		case 3: z.a = sub8(z.a, value, z.f & FC); break;
+		case 4: z.a &= value; z.f = flagsSZP(z.a) | FH; break;
+		case 5: z.a ^= value; z.f = flagsSZP(z.a); break;
+		case 6: z.a |= value; z.f = flagsSZP(z.a); break;
+		default: sub8(z.a, value, 0);
+	}
+}
+
+
+
+static uint8_t inc8(uint8_t value)
+{
+	uint8_t result = value + 1;
+	z.f = (z.f & FC) | (result & FS) | (result ? 0 : FZ) | ((result & 0x0F) ? 0 : FH) | (value == 0x7F ? FPV : 0);
+	return result;
+}
+
+
+
+static uint8_t dec8(uint8_t value)
+{
+	uint8_t result = value - 1;
+	z.f = (z.f & FC) | FN | (result & FS) | (result ? 0 : FZ) | ((value & 0x0F) ? 0 : FH) | (value == 0x80 ? FPV : 0);
+	return result;
+}
+
+
+
+static uint16_t add16(uint16_t a, uint16_t b)
+{
+	uint32_t result = a + b;
+	z.f = (z.f & (FS | FZ | FPV)) | (((a ^ b ^ result) >> 8) & FH) | ((result >> 16) ? FC : 0);
+	return (uint16_t)result;
+}
+
+
+
+static uint16_t adc16(uint16_t a, uint16_t b)
+{
+	uint32_t result = a + b + (z.f & FC);
+	z.f = ((result >> 8) & FS) | ((result & 0xFFFF) ? 0 : FZ) | (((a ^ b ^ result) >> 8) & FH)
+		| ((~(a ^ b) & (a ^ result) & 0x8000) ? FPV : 0) | ((result >> 16) ? FC : 0);
+	return (uint16_t)result;
+}
+
+
+
+static uint16_t sbc16(uint16_t a, uint16_t b)
+{
+	uint32_t result = a - b - (z.f & FC);
+	z.f = FN | ((result >> 8) & FS) | ((result & 0xFFFF) ? 0 : FZ) | (((a ^ b ^ result) >> 8) & FH)
+		| (((a ^ b) & (a ^ result) & 0x8000) ? FPV : 0) | ((result & 0x10000) ? FC : 0);
+	return (uint16_t)result;
+}
+
+
+
+// RLC, RRC, RL, RR, SLA, SRA, SLL, SRL
+static uint8_t rot(int op, uint8_t value)
+{
+	uint8_t carry;
+
+	switch (op)
+	{
+		case 0: carry = value >> 7; value = (value << 1) | carry; break;
+		case 1: carry = value & 1; value = (value >> 1) | (carry << 7); break;
+		case 2: carry = value >> 7; value = (value << 1) | (z.f & FC); break;
+		case 3: carry = value & 1; value = (value >> 1) | ((z.f & FC) << 7); break;
+		case 4: carry = value >> 7; value <<= 1; break;
+		case 5: carry = value & 1; value = (value >> 1) | (value & 0x80); break;
+		case 6: carry = value >> 7; value = (value << 1) | 1; break;
+		default: carry = value & 1; value >>= 1;
+	}
+	z.f = flagsSZP(value) | carry;
+	return value;
+}
+
+
+
+static int condition(int cc)
+{
+	switch (cc)
+	{
+		case 0: return !(z.f & FZ);
+		case 1: return z.f & FZ;
+		case 2: return !(z.f & FC);
+		case 3: return z.f & FC;
+		case 4: return !(z.f & FPV);
+		case 5: return z.f & FPV;
+		case 6: return !(z.f & FS);
+	}
+	return z.f & FS;
+}
+
+
+
+static void daa(void)
+{
+	uint8_t a = z.a, correction = 0, carry = 0, half;
+
+	if ((z.f & FH) || (a & 0x0F) > 9) correction |= 0x06;
+	if ((z.f & FC) || a > 0x99) { correction |= 0x60; carry = FC; }
+	if (z.f & FN)
+	{
+		half = (z.f & FH) && (a & 0x0F) < 6;
+		a -= correction;
+	}
+	else
+	{
+		half = (a & 0x0F) > 9;
+		a += correction;
+	}
+	z.f = flagsSZP(a) | carry | (z.f & FN) | (half ? FH : 0);
+	z.a = a;
+}
+
+
+
+// CB (idx = 0) and DDCB/FDCB; returns T-states without the wait states
+static int opCB(void)
+{
+	int x, y, r, t;
+	uint16_t addr = 0;
+	uint8_t op, value;
+
+	if (idx)
+	{
+		addr = getHL() + (int8_t)fetch();
+		op = fetch();
+	}
+	else
+	{
+		op = fetch();
+		incR();
+	}
+
+	x = op >> 6;
+	y = (op >> 3) & 7;
+	r = op & 7;
+
+	if (idx || r == 6)
+	{
+		if (!idx) addr = getHL();
+		value = mem[addr];
+		t = idx ? (x == 1 ? 16 : 19) : (x == 1 ? 12 : 15);
+	}
+	else
+	{
+		value = getR(r, 0);
+		t = 8;
+	}
+
+	switch (x)
+	{
+		case 0: value = rot(y, value); break;
+		case 1:
+			z.f = (z.f & FC) | FH | ((value & (1 << y)) ? 0 : (FZ | FPV)) | ((y == 7 && (value & 0x80)) ? FS : 0);
+			return t;
+		case 2: value &= ~(1 << y); break;
+		default: value |= 1 << y;
+	}
+
+	if (idx || r == 6)
+	{
+		mem[addr] = value;
+		if (idx && r != 6) setR(r, value, 0);
+	}
+	else setR(r, value, 0);
+
+	return t;
+}
+
+
+
+// ED; returns T-states without the wait states
+static int opED(void)
+{
+	int x, y, zz, p, q, t = 8;
+	uint8_t op = fetch(), value;
+	uint16_t hl, bc, de;
+
+	incR();
+	idx = 0;
+	x = op >> 6;
+	y = (op >> 3) & 7;
+	zz = op & 7;
+	p = y >> 1;
+	q = y & 1;
+
+	if (x == 1)
+	{
+		switch (zz)
+		{
+			case 0:		// IN r,(C)
+				value = PortIn(z.c, T0 + 10);
+				if (y != 6) setR(y, value, 0);
+				z.f = (z.f & FC) | flagsSZP(value);
+				return 12;
+			case 1:		// OUT (C),r
+				PortOut(z.c, y == 6 ? 0 : getR(y, 0), T0 + 10);
+				return 12;
+			case 2:
+				if (q) setHL(adc16(getHL(), getRP(p)));
+				else setHL(sbc16(getHL(), getRP(p)));
+				return 15;
+			case 3:
+				if (q) setRP(p, rd16(fetch16()));
+				else wr16(fetch16(), getRP(p));
+				return 20;
+			case 4:		// NEG
+				z.a = sub8(0, z.a, 0);
+				return 8;
+			case 5:		// RETN, RETI
+				z.pc = pop();
+				z.iff1 = z.iff2;
+				return 14;
+			case 6:
+				z.im = (y & 3) == 0 ? 0 : (y & 3) == 2 ? 1 : 2;
+				return 8;
+			default:
+				switch (y)
+				{
+					case 0: z.i = z.a; return 9;
+					case 1: z.r = z.a; return 9;
+					case 2:
+						z.a = z.i;
+						z.f = (z.f & FC) | (z.a & FS) | (z.a ? 0 : FZ) | (z.iff2 ? FPV : 0);
+						return 9;
+					case 3:
+						z.a = z.r;
+						z.f = (z.f & FC) | (z.a & FS) | (z.a ? 0 : FZ) | (z.iff2 ? FPV : 0);
+						return 9;
+					case 4:		// RRD
+						hl = getHL();
+						value = mem[hl];
+						mem[hl] = (z.a << 4) | (value >> 4);
+						z.a = (z.a & 0xF0) | (value & 0x0F);
+						z.f = (z.f & FC) | flagsSZP(z.a);
+						return 18;
+					case 5:		// RLD
+						hl = getHL();
+						value = mem[hl];
+						mem[hl] = (value << 4) | (z.a & 0x0F);
+						z.a = (z.a & 0xF0) | (value >> 4);
+						z.f = (z.f & FC) | flagsSZP(z.a);
+						return 18;
+				}
+				return 8;
+		}
+	}
+
+	if (x == 2 && zz <= 3 && y >= 4)
+	{
+		int dir = (y & 1) ? -1 : 1;
+		int repeat = y >= 6;
+
+		hl = getHL();
+		bc = getRP(0);
+		de = getRP(1);
+		t = 16;
+
+		switch (zz)
+		{
+			case 0:		// LDI, LDD, LDIR, LDDR
+				mem[de] = mem[hl];
+				setRP(1, de + dir);
+				setHL(hl + dir);
+				bc--;
+				setRP(0, bc);
+				z.f = (z.f & (FS | FZ | FC)) | (bc ? FPV : 0);
+				if (repeat && bc) { z.pc -= 2; t = 21; }
+				break;
+			case 1:		// CPI, CPD, CPIR, CPDR
+			{
+				uint8_t carry = z.f & FC, result;
+				value = mem[hl];
+				result = sub8(z.a, value, 0);
+				setHL(hl + dir);
+				bc--;
+				setRP(0, bc);
+				z.f = (z.f & (FS | FZ | FH | FN)) | carry | (bc ? FPV : 0);
+				if (repeat && bc && result) { z.pc -= 2; t = 21; }
+				break;
+			}
+			case 2:		// INI, IND, INIR, INDR
+				value = PortIn(z.c, T0 + 11);
+				mem[hl] = value;
+				setHL(hl + dir);
+				z.b--;
+				z.f = FN | (z.b & FS) | (z.b ? 0 : FZ);
+				if (repeat && z.b) { z.pc -= 2; t = 21; }
+				break;
+			default:	// OUTI, OUTD, OTIR, OTDR
+				value = mem[hl];
+				z.b--;
+				PortOut(z.c, value, T0 + 14);
+				setHL(hl + dir);
+				z.f = FN | (z.b & FS) | (z.b ? 0 : FZ);
+				if (repeat && z.b) { z.pc -= 2; t = 21; }
+		}
+		return t;
+	}
+
+	return t;
+}
+
+
+
+/* -----------------------------------------------------------------------------
+ Executes one instruction and returns its T-states
+ (with the wait state of the MSX in each M1 cycle)
+----------------------------------------------------------------------------- */
+static int Step(void)
+{
+	int x, y, zz, p, q, t = 0, m1 = 1;
+	uint8_t op, value;
+	uint16_t addr, tmp;
+
+	T0 = T;
+	PC0 = z.pc;
+	idx = 0;
+	incR();
+	op = fetch();
+
+	while (op == 0xDD || op == 0xFD)
+	{
+		idx = op == 0xDD ? 1 : 2;
+		t += 4;
+		m1++;
+		incR();
+		op = fetch();
+	}
+
+	x = op >> 6;
+	y = (op >> 3) & 7;
+	zz = op & 7;
+	p = y >> 1;
+	q = y & 1;
+
+	switch (x)
+	{
+	case 0:
+		switch (zz)
+		{
+		case 0:
+			switch (y)
+			{
+				case 0: t += 4; break;
+				case 1:
+					tmp = z.a; z.a = z.a_; z.a_ = (uint8_t)tmp;
+					tmp = z.f; z.f = z.f_; z.f_ = (uint8_t)tmp;
+					t += 4;
+					break;
+				case 2:
+					value = fetch();
+					if (--z.b) { z.pc += (int8_t)value; t += 13; }
+					else t += 8;
+					break;
+				case 3:
+					value = fetch();
+					z.pc += (int8_t)value;
+					t += 12;
+					break;
+				default:
+					value = fetch();
+					if (condition(y - 4)) { z.pc += (int8_t)value; t += 12; }
+					else t += 7;
+			}
+			break;
+
+		case 1:
+			if (q) { setHL(add16(getHL(), getRP(p))); t += 11; }
+			else { setRP(p, fetch16()); t += 10; }
+			break;
+
+		case 2:
+			switch (y)
+			{
+				case 0: mem[getRP(0)] = z.a; t += 7; break;
+				case 1: z.a = mem[getRP(0)]; t += 7; break;
+				case 2: mem[getRP(1)] = z.a; t += 7; break;
+				case 3: z.a = mem[getRP(1)]; t += 7; break;
+				case 4: wr16(fetch16(), getHL()); t += 16; break;
+				case 5: setHL(rd16(fetch16())); t += 16; break;
+				case 6: mem[fetch16()] = z.a; t += 13; break;
+				default: z.a = mem[fetch16()]; t += 13;
+			}
+			break;
+
+		case 3:
+			setRP(p, getRP(p) + (q ? -1 : 1));
+			t += 6;
+			break;
+
+		case 4:
+		case 5:
+			if (y == 6)
+			{
+				addr = memAddr();
+				mem[addr] = zz == 4 ? inc8(mem[addr]) : dec8(mem[addr]);
+				t += idx ? 19 : 11;
+			}
+			else
+			{
+				setR(y, zz == 4 ? inc8(getR(y, 1)) : dec8(getR(y, 1)), 1);
+				t += 4;
+			}
+			break;
+
+		case 6:
+			if (y == 6)
+			{
+				addr = memAddr();
+				mem[addr] = fetch();
+				t += idx ? 15 : 10;
+			}
+			else
+			{
+				setR(y, fetch(), 1);
+				t += 7;
+			}
+			break;
+
+		default:
+			switch (y)
+			{
+				case 0:
+					z.a = (z.a << 1) | (z.a >> 7);
+					z.f = (z.f & (FS | FZ | FPV)) | (z.a & FC);
+					break;
+				case 1:
+					z.f = (z.f & (FS | FZ | FPV)) | (z.a & FC);
+					z.a = (z.a >> 1) | (z.a << 7);
+					break;
+				case 2:
+					value = z.a >> 7;
+					z.a = (z.a << 1) | (z.f & FC);
+					z.f = (z.f & (FS | FZ | FPV)) | value;
+					break;
+				case 3:
+					value = z.a & 1;
+					z.a = (z.a >> 1) | ((z.f & FC) << 7);
+					z.f = (z.f & (FS | FZ | FPV)) | value;
+					break;
+				case 4: daa(); break;
+				case 5: z.a = ~z.a; z.f |= FH | FN; break;
+				case 6: z.f = (z.f & (FS | FZ | FPV)) | FC; break;
+				default: z.f = (z.f & (FS | FZ | FPV)) | ((z.f & FC) ? FH : FC);
+			}
+			t += 4;
+		}
+		break;
+
+	case 1:
+		if (y == 6 && zz == 6)
+		{
+			z.halted = 1;
+			t += 4;
+		}
+		else if (y == 6)
+		{
+			addr = memAddr();
+			mem[addr] = getR(zz, 0);
+			t += idx ? 15 : 7;
+		}
+		else if (zz == 6)
+		{
+			addr = memAddr();
+			setR(y, mem[addr], 0);
+			t += idx ? 15 : 7;
+		}
+		else
+		{
+			setR(y, getR(zz, 1), 1);
+			t += 4;
+		}
+		break;
+
+	case 2:
+		if (zz == 6)
+		{
+			addr = memAddr();
+			alu(y, mem[addr]);
+			t += idx ? 15 : 7;
+		}
+		else
+		{
+			alu(y, getR(zz, 1));
+			t += 4;
+		}
+		break;
+
+	default:
+		switch (zz)
+		{
+		case 0:
+			if (condition(y)) { z.pc = pop(); t += 11; }
+			else t += 5;
+			break;
+
+		case 1:
+			if (!q) { setRP2(p, pop()); t += 10; }
+			else switch (p)
+			{
+				case 0: z.pc = pop(); t += 10; break;
+				case 1:
+					tmp = z.b; z.b = z.b_; z.b_ = (uint8_t)tmp;
+					tmp = z.c; z.c = z.c_; z.c_ = (uint8_t)tmp;
+					tmp = z.d; z.d = z.d_; z.d_ = (uint8_t)tmp;
+					tmp = z.e; z.e = z.e_; z.e_ = (uint8_t)tmp;
+					tmp = z.h; z.h = z.h_; z.h_ = (uint8_t)tmp;
+					tmp = z.l; z.l = z.l_; z.l_ = (uint8_t)tmp;
+					t += 4;
+					break;
+				case 2: z.pc = getHL(); t += 4; break;
+				default: z.sp = getHL(); t += 6;
+			}
+			break;
+
+		case 2:
+			addr = fetch16();
+			if (condition(y)) z.pc = addr;
+			t += 10;
+			break;
+
+		case 3:
+			switch (y)
+			{
+				case 0: z.pc = fetch16(); t += 10; break;
+				case 1:
+					m1++;
+					t += opCB();
+					break;
+				case 2:
+					value = fetch();
+					PortOut(value, z.a, T0 + 8);
+					t += 11;
+					break;
+				case 3:
+					value = fetch();
+					z.a = PortIn(value, T0 + 8);
+					t += 11;
+					break;
+				case 4:
+					tmp = rd16(z.sp);
+					wr16(z.sp, getHL());
+					setHL(tmp);
+					t += 19;
+					break;
+				case 5:
+					tmp = z.d; z.d = z.h; z.h = (uint8_t)tmp;
+					tmp = z.e; z.e = z.l; z.l = (uint8_t)tmp;
+					t += 4;
+					break;
+				case 6: z.iff1 = z.iff2 = 0; t += 4; break;
+				default: z.iff1 = z.iff2 = 1; t += 4;
+			}
+			break;
+
+		case 4:
+			addr = fetch16();
+			if (condition(y)) { push(z.pc); z.pc = addr; t += 17; }
+			else t += 10;
+			break;
+
+		case 5:
+			if (!q) { push(getRP2(p)); t += 11; }
+			else if (p == 0)
+			{
+				addr = fetch16();
+				push(z.pc);
+				z.pc = addr;
+				t += 17;
+			}
+			else if (p == 2)
+			{
+				m1++;
+				t += opED();
+			}
+			break;
+
+		case 6:
+			alu(y, fetch());
+			t += 7;
+			break;
+
+		default:
+			push(z.pc);
+			z.pc = y * 8;
+			t += 11;
+		}
+	}
+
+	return t + m1;
+}
+
+
+
+
+/* =============================================================================
+ Loader
+============================================================================= */
+
+static int hexValue(const char* text, int digits)
+{
+	int value = 0;
+	while (digits--)
+	{
+		char c = *text++;
+		value <<= 4;
+		if (c >= '0' && c <= '9') value |= c - '0';
+		else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+		else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+		else return -1;
+	}
+	return value;
+}
+
+
+
+static int LoadIHX(const char* filename)
+{
+	char line[600];
+	FILE* file = fopen(filename, "r");
+
+	if (!file)
+	{
+		fprintf(stderr, "vdpsim: can't open %s\n", filename);
+		return 0;
+	}
+
+	while (fgets(line, sizeof(line), file))
+	{
+		int size, addr, type, i;
+
+		if (line[0] != ':') continue;
+		size = hexValue(line + 1, 2);
+		addr = hexValue(line + 3, 4);
+		type = hexValue(line + 7, 2);
+		if (size < 0 || addr < 0 || type < 0) break;
+		if (type == 1) break;
+		if (type != 0) continue;
+		for (i = 0; i < size; i++)
+		{
+			int value = hexValue(line + 9 + i * 2, 2);
+			if (value < 0) break;
+			mem[(addr + i) & 0xFFFF] = (uint8_t)value;
+		}
+	}
+
+	fclose(file);
+	return 1;
+}
+
+
+
+// .noi (DEF name 0xADDR) or .map of sdld (00000200  name)
+static int LoadSymbols(const char* filename)
+{
+	char line[256], name[48];
+	unsigned int addr;
+	FILE* file = fopen(filename, "r");
+
+	if (!file)
+	{
+		fprintf(stderr, "vdpsim: can't open %s\n", filename);
+		return 0;
+	}
+
+	while (fgets(line, sizeof(line), file) && symbolCount < MAX_SYMBOLS)
+	{
+		if (sscanf(line, "DEF %47s 0x%x", name, &addr) != 2
+			&& (sscanf(line, " %8x %47s", &addr, name) != 2 || strspn(line + strspn(line, " \t"), "0123456789ABCDEFabcdef") != 8))
+			continue;
+		if (!(name[0] == '_' || (name[0] >= 'A' && name[0] <= 'Z') || (name[0] >= 'a' && name[0] <= 'z'))) continue;
+		if (!strncmp(name, "s__", 3) || !strncmp(name, "l__", 3)) continue;
+		symbols[symbolCount].addr = (uint16_t)addr;
+		strcpy(symbols[symbolCount].name, name);
+		symbolCount++;
+	}
+
+	fclose(file);
+	return 1;
+}
+
+
+
+
+/* =============================================================================
+ Run
+============================================================================= */
+
+static void Reset(void)
+{
+	int i;
+
+	for (i = 0; i < 256; i++)
+	{
+		int bits = i, ones = 0;
+		while (bits) { ones += bits & 1; bits >>= 1; }
+		parity[i] = (ones & 1) ? 0 : FPV;
+	}
+
+	memset(&z, 0, sizeof(z));
+	memset(&vdp, 0, sizeof(vdp));
+	memset(&count, 0, sizeof(count));
+	memset(mem, 0, sizeof(mem));
+	reportedCount = 0;
+	z.a = z.f = 0xFF;
+	z.sp = 0xFFFF;
+	T = 0;
+	benchRunning = 0;
+	benchArm = 0;
+	benchNameLen = 0;
+	benchRows = 0;
+	strcpy(benchName, "unnamed");
+}
+
+
+
+static int Run(void)
+{
+	while (!z.halted)
+	{
+		T += Step();
+
+		if (benchArm)
+		{
+			benchArm = 0;
+			benchRunning = 1;
+			benchStart = T;
+			benchBytes = count.bytes;
+			benchSetups = count.setups;
+			benchRegisters = count.registers;
+			benchViolations = count.violations;
+		}
+
+		if (T > MAX_TSTATES)
+		{
+			fprintf(stderr, "vdpsim: no HALT after %llu T-states (PC=%04X)\n", T, z.pc);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+
+
+/* =============================================================================
+ Self-test
+ Hand-assembled fixtures. Each one starts with PROLOGUE (BLK=1, write address
+ 0x1B00) and ends with HALT. A fixture can prepare the RAM before it runs and
+ count the wrong bytes of the VRAM after it.
+============================================================================= */
+
+#define PROLOGUE \
+	0x31, 0x00, 0xF0,			/* ld   SP,#0xF000 */ \
+	0x3E, 0xE0, 0xD3, 0x99,		/* ld   A,#0xE0 ; out (0x99),A */ \
+	0x3E, 0x81, 0xD3, 0x99,		/* ld   A,#0x81 ; out (0x99),A  R#1 = 0xE0 (BLK=1) */ \
+	0x3E, 0x00, 0xD3, 0x99,		/* ld   A,#0x00 ; out (0x99),A */ \
+	0x3E, 0x5B, 0xD3, 0x99		/* ld   A,#0x5B ; out (0x99),A  write 0x1B00 */
+
+// ClearSprites v1.7.1: 27 T-states between the Y and X writes
+static const uint8_t FIXTURE_CLEARSPRITES_OLD[] = {
+	PROLOGUE,
+	0x06, 0x20,					// ld   B,#32
+	0x0E, 0xD1,					// ld   C,#209
+	0x79,						// loop: ld A,C
+	0xD3, 0x98,					// out  (0x98),A  Y
+	0xAF,						// xor  A
+	0x00, 0x00,					// nop ; nop
+	0xD3, 0x98,					// out  (0x98),A  X
+	0x03, 0x00, 0x00,			// inc  BC ; nop ; nop
+	0xD3, 0x98,					// out  (0x98),A  pattern
+	0x0B, 0x00, 0x00,			// dec  BC ; nop ; nop
+	0xD3, 0x98,					// out  (0x98),A  color
+	0x10, 0xEC,					// djnz loop
+	0x76						// halt
+};
+
+// ClearSprites v1.8: 32 T-states between the Y and X writes
+static const uint8_t FIXTURE_CLEARSPRITES[] = {
+	PROLOGUE,
+	0x06, 0x20,					// ld   B,#32
+	0x0E, 0xD1,					// ld   C,#209
+	0x79,						// loop: ld A,C
+	0xD3, 0x98,					// out  (0x98),A  Y
+	0xAF,						// xor  A
+	0x00, 0x00, 0x00,			// nop ; nop ; nop
+	0xD3, 0x98,					// out  (0x98),A  X
+	0x03, 0x00, 0x00,			// inc  BC ; nop ; nop
+	0xD3, 0x98,					// out  (0x98),A  pattern
+	0x0B, 0x00, 0x00,			// dec  BC ; nop ; nop
+	0xD3, 0x98,					// out  (0x98),A  color
+	0x10, 0xEB,					// djnz loop
+	0x76						// halt
+};
+
+// LDIR2VRAM loop: OUTI + JP NZ = 29 T-states
+static const uint8_t FIXTURE_LDIR2VRAM[] = {
+	PROLOGUE,
+	0x21, 0x00, 0x80,			// ld   HL,#0x8000
+	0x06, 0x10,					// ld   B,#16
+	0x0E, 0x98,					// ld   C,#0x98
+	0xED, 0xA3,					// loop: outi
+	0xC2, 0x1A, 0x00,			// jp   NZ,loop
+	0x76						// halt
+};
+
+// OTIR: 23 T-states, only valid with the display disabled
+static const uint8_t FIXTURE_OTIR[] = {
+	PROLOGUE,
+	0x21, 0x00, 0x80,			// ld   HL,#0x8000
+	0x06, 0x10,					// ld   B,#16
+	0x0E, 0x98,					// ld   C,#0x98
+	0xED, 0xB3,					// otir
+	0x76						// halt
+};
+
+static const uint8_t FIXTURE_OTIR_BLANK[] = {
+	PROLOGUE,
+	0x3E, 0xA0, 0xD3, 0x99,		// ld   A,#0xA0 ; out (0x99),A
+	0x3E, 0x81, 0xD3, 0x99,		// ld   A,#0x81 ; out (0x99),A  R#1 = 0xA0 (BLK=0)
+	0x21, 0x00, 0x80,			// ld   HL,#0x8000
+	0x06, 0x10,					// ld   B,#16
+	0x0E, 0x98,					// ld   C,#0x98
+	0xED, 0xB3,					// otir
+	0x76						// halt
+};
+
+// VPEEK v1.7.1: SetVDPtoREAD (out, ei, ret) followed by IN = 28 T-states
+static const uint8_t FIXTURE_VPEEK_OLD[] = {
+	PROLOGUE,
+	0x21, 0x00, 0x1B,			// ld   HL,#0x1B00
+	0xCD, 0x1C, 0x00,			// call SetVDPtoREAD
+	0xDB, 0x98,					// in   A,(0x98)
+	0x76,						// halt
+	0x7D, 0xF3, 0xD3, 0x99,		// SetVDPtoREAD: ld A,L ; di ; out (0x99),A
+	0x7C, 0xE6, 0x3F, 0xD3, 0x99,	// ld A,H ; and #0x3F ; out (0x99),A
+	0xFB, 0xC9					// ei ; ret
+};
+
+// VPEEK v1.8: NOP before the IN = 33 T-states
+static const uint8_t FIXTURE_VPEEK[] = {
+	PROLOGUE,
+	0x21, 0x00, 0x1B,			// ld   HL,#0x1B00
+	0xCD, 0x1D, 0x00,			// call SetVDPtoREAD
+	0x00,						// nop
+	0xDB, 0x98,					// in   A,(0x98)
+	0x76,						// halt
+	0x7D, 0xF3, 0xD3, 0x99,		// SetVDPtoREAD: ld A,L ; di ; out (0x99),A
+	0x7C, 0xE6, 0x3F, 0xD3, 0x99,	// ld A,H ; and #0x3F ; out (0x99),A
+	0xFB, 0xC9					// ei ; ret
+};
+
+// FlushScroll (VDP_SCROLL). SCROLL_window at 0x8000, SCROLL_cy at 0x9000 and
+// SCROLL_cx at 0x9001 (see ScrollSetup). Name table at 0x1800.
+#define SCROLL_OLD_WRONG	736		// v1.0 after ScrollRight: the 23 rows after the first one
+
+#define SCROLL_PROLOGUE \
+	PROLOGUE, \
+	0x3E, 0x00, 0xD3, 0x99,		/* ld   A,#0x00 ; out (0x99),A */ \
+	0x3E, 0x58, 0xD3, 0x99,		/* ld   A,#0x58 ; out (0x99),A  write 0x1800 */ \
+	0xCD, 0x1F, 0x00,			/* call FlushScroll */ \
+	0x76,						/* halt */ \
+	0x3A, 0x00, 0x90,			/* FlushScroll: ld A,(SCROLL_cy) */ \
+	0xCD, GETROW, 0x00,			/* call GetRow */ \
+	0x0E, 0x98,					/* ld   C,#0x98 */ \
+	0x3A, 0x00, 0x90,			/* ld   A,(SCROLL_cy) */ \
+	0xED, 0x44,					/* neg */ \
+	0xC6, 0x18,					/* add  A,#24 */ \
+	0xCD, 0x39, 0x00,			/* call OutRows */ \
+	0x3A, 0x00, 0x90,			/* ld   A,(SCROLL_cy) */ \
+	0xB7,						/* or   A */ \
+	0xC8,						/* ret  Z */ \
+	0x21, 0x00, 0x80,			/* ld   HL,#SCROLL_window */ \
+	0xF5,						/* OutRows: push AF */ \
+	0xE5,						/* push HL */ \
+	0x3A, 0x01, 0x90,			/* ld   A,(SCROLL_cx) */ \
+	0x5F,						/* ld   E,A */ \
+	0x16, 0x00,					/* ld   D,#0 */ \
+	0x19,						/* add  HL,DE */ \
+	0x3E, 0x20,					/* ld   A,#32 */ \
+	0x93,						/* sub  E */ \
+	0x47,						/* ld   B,A */ \
+	0xED, 0xA3,					/* out1: outi */ \
+	0xC2, 0x46, 0x00,			/* jp   NZ,out1 */ \
+	0xE1,						/* pop  HL */ \
+	0x7B,						/* ld   A,E */ \
+	0xB7						/* or   A */
+
+#define SCROLL_GETROW \
+	0x6F,						/* GetRow: ld L,A */ \
+	0x26, 0x00,					/* ld   H,#0 */ \
+	0x29, 0x29, 0x29, 0x29, 0x29,	/* add  HL,HL (x32) */ \
+	0x11, 0x00, 0x80,			/* ld   DE,#SCROLL_window */ \
+	0x19,						/* add  HL,DE */ \
+	0xC9						/* ret */
+
+// VDP_SCROLL v1.0: the second run leaves HL at row + cx
+#define GETROW	0x5F
+static const uint8_t FIXTURE_SCROLL_OLD[] = {
+	SCROLL_PROLOGUE,
+	0x28, 0x06,					// jr   Z,next
+	0x47,						// ld   B,A
+	0xED, 0xA3,					// out2: outi
+	0xC2, 0x51, 0x00,			// jp   NZ,out2
+	0x11, 0x20, 0x00,			// next: ld DE,#32
+	0x19,						// add  HL,DE
+	0xF1,						// pop  AF
+	0x3D,						// dec  A
+	0x20, 0xDB,					// jr   NZ,OutRows
+	0xC9,						// ret
+	SCROLL_GETROW
+};
+#undef GETROW
+
+// VDP_SCROLL v1.1: the next row starts at row + 32
+#define GETROW	0x61
+static const uint8_t FIXTURE_SCROLL[] = {
+	SCROLL_PROLOGUE,
+	0x28, 0x08,					// jr   Z,next
+	0xE5,						// push HL
+	0x47,						// ld   B,A
+	0xED, 0xA3,					// out2: outi
+	0xC2, 0x52, 0x00,			// jp   NZ,out2
+	0xE1,						// pop  HL
+	0x11, 0x20, 0x00,			// next: ld DE,#32
+	0x19,						// add  HL,DE
+	0xF1,						// pop  AF
+	0x3D,						// dec  A
+	0x20, 0xD9,					// jr   NZ,OutRows
+	0xC9,						// ret
+	SCROLL_GETROW
+};
+#undef GETROW
+
+
+
+// tile of the map at column x and row y
+static uint8_t ScrollTile(int x, int y)
+{
+	return (uint8_t)(x + y * 37);
+}
+
+
+
+// window of a map scrolled from (0,0) to (cx,cy): the ring as InitScroll
+// and cx ScrollRight and cy ScrollDown leave it
+static void ScrollSetup(int cx, int cy)
+{
+	int row, column;
+
+	for (row = 0; row < 24; row++)
+		for (column = 0; column < 32; column++)
+			mem[0x8000 + row * 32 + column] = ScrollTile(cx + ((column - cx) & 31), cy + (row - cy + 24) % 24);
+	mem[0x9000] = (uint8_t)cy;
+	mem[0x9001] = (uint8_t)cx;
+}
+
+static void ScrollRight(void)		{ ScrollSetup(1, 0); }
+static void ScrollDown(void)		{ ScrollSetup(0, 1); }
+static void ScrollRightDown(void)	{ ScrollSetup(5, 7); }
+
+
+
+// bytes of the name table different from the window at (cx,cy)
+static unsigned long ScrollCheck(void)
+{
+	unsigned long wrong = 0;
+	int row, column;
+
+	for (row = 0; row < 24; row++)
+		for (column = 0; column < 32; column++)
+			if (vdp.vram[0x1800 + row * 32 + column] != ScrollTile(mem[0x9001] + column, mem[0x9000] + row)) wrong++;
+	return wrong;
+}
+
+
+
+static const struct {
+	const char* name;
+	const uint8_t* code;
+	unsigned int size;
+	unsigned long violations;	// expected
+	unsigned long bytes;		// expected
+	void (*setup)(void);		// prepares the RAM (optional)
+	unsigned long (*check)(void);	// wrong bytes in VRAM (optional)
+	unsigned long wrong;		// expected
+} FIXTURES[] = {
+	{"ClearSprites v1.7.1 (27 T-states)", FIXTURE_CLEARSPRITES_OLD, sizeof(FIXTURE_CLEARSPRITES_OLD), 32, 128, NULL, NULL, 0},
+	{"ClearSprites", FIXTURE_CLEARSPRITES, sizeof(FIXTURE_CLEARSPRITES), 0, 128, NULL, NULL, 0},
+	{"LDIR2VRAM loop (29 T-states)", FIXTURE_LDIR2VRAM, sizeof(FIXTURE_LDIR2VRAM), 0, 16, NULL, NULL, 0},
+	{"OTIR, display enabled", FIXTURE_OTIR, sizeof(FIXTURE_OTIR), 15, 16, NULL, NULL, 0},
+	{"OTIR, display disabled", FIXTURE_OTIR_BLANK, sizeof(FIXTURE_OTIR_BLANK), 0, 16, NULL, NULL, 0},
+	{"VPEEK v1.7.1 (28 T-states)", FIXTURE_VPEEK_OLD, sizeof(FIXTURE_VPEEK_OLD), 1, 1, NULL, NULL, 0},
+	{"VPEEK", FIXTURE_VPEEK, sizeof(FIXTURE_VPEEK), 0, 1, NULL, NULL, 0},
+	{"FlushScroll v1.0 after ScrollRight", FIXTURE_SCROLL_OLD, sizeof(FIXTURE_SCROLL_OLD), 0, 768, ScrollRight, ScrollCheck, SCROLL_OLD_WRONG},
+	{"FlushScroll after ScrollRight", FIXTURE_SCROLL, sizeof(FIXTURE_SCROLL), 0, 768, ScrollRight, ScrollCheck, 0},
+	{"FlushScroll after ScrollDown", FIXTURE_SCROLL, sizeof(FIXTURE_SCROLL), 0, 768, ScrollDown, ScrollCheck, 0},
+	{"FlushScroll after ScrollRight and ScrollDown", FIXTURE_SCROLL, sizeof(FIXTURE_SCROLL), 0, 768, ScrollRightDown, ScrollCheck, 0},
+};
+
+
+
+static int SelfTest(void)
+{
+	unsigned int i;
+	int failed = 0;
+
+	quiet = 1;
+	for (i = 0; i < sizeof(FIXTURES) / sizeof(FIXTURES[0]); i++)
+	{
+		int ok;
+		unsigned long wrong = 0;
+
+		Reset();
+		memcpy(mem, FIXTURES[i].code, FIXTURES[i].size);
+		if (FIXTURES[i].setup) FIXTURES[i].setup();
+		ok = Run() && count.violations == FIXTURES[i].violations && count.bytes == FIXTURES[i].bytes;
+		if (FIXTURES[i].check)
+		{
+			wrong = FIXTURES[i].check();
+			if (wrong != FIXTURES[i].wrong) ok = 0;
+		}
+		printf("%s %s: %lu violations (expected %lu), %lu bytes", ok ? "PASS" : "FAIL",
+			FIXTURES[i].name, count.violations, FIXTURES[i].violations, count.bytes);
+		if (FIXTURES[i].check) printf(", %lu wrong in VRAM (expected %lu)", wrong, FIXTURES[i].wrong);
+		printf("\n");
+		if (!ok) failed++;
+	}
+
+	return failed ? 1 : 0;
+}
+
+
+
+int main(int argc, char* argv[])
+{
+	const char* program = NULL;
+	const char* symbolFile = NULL;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-t")) return SelfTest();
+		else if (!strcmp(argv[i], "-b")) beamMode = 1;
+		else if (!strcmp(argv[i], "-s") && i + 1 < argc) symbolFile = argv[++i];
+		else if (argv[i][0] != '-' && !program) program = argv[i];
+		else program = NULL, i = argc;
+	}
+
+	if (!program)
+	{
+		fprintf(stderr, "usage: vdpsim [-b] [-s program.map|.noi] program.ihx > results.csv\n"
+						"       vdpsim -t\n");
+		return 2;
+	}
+
+	Reset();
+	if (!LoadIHX(program)) return 1;
+	if (symbolFile && !LoadSymbols(symbolFile)) return 1;
+
+	printf("name,tstates,bytes,tstates_per_byte,setups,registers,violations\n");
+	if (!Run()) return 1;
+
+	fprintf(stderr, "vdpsim: %d measures, %llu T-states, %lu VRAM timing violations\n", benchRows, T, count.violations);
+	return count.violations ? 3 : 0;
+}